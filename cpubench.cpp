@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include "include/Memory.hpp"
+#include "include/Ricoh2A03.hpp"
+
+// runs the CPU alone over a small looping program in flat memory and reports instructions per second
+// (for comparing interpreter cores; see "switchcore" in CMakeLists.txt)
+// usage: NES_CPUBench [cycles]
+
+namespace
+{
+    struct FlatMemory final : public NES::Memory     // 64kB of RAM with no mirroring or registers
+    {
+        uint8_t cpuMemory[0x10000] = {0};
+
+        uint8_t cpuRead(uint16_t addr) {return cpuMemory[addr];}
+        bool cpuWrite(uint16_t addr, uint8_t data) {cpuMemory[addr] = data; return true;}
+
+        // filler functions as there is no PPU, APU or cartridge
+        uint8_t ppuRead(uint16_t) {return 0x00;}
+        bool ppuWrite(uint16_t, uint8_t) {return false;}
+        #ifdef DEBUG
+            uint8_t cpuReadDebug(uint16_t addr) {return cpuMemory[addr];}
+            uint8_t ppuReadDebug(uint16_t) {return 0x00;}
+        #endif
+        uint8_t controllerRead(uint8_t) {return 0x00;}
+        void controllerWrite(uint8_t, uint8_t) {}
+        void mapperIrqReset() {}
+        bool mapperWatchesA12() {return false;}
+        void ppuRequestDMA() {}
+        void finalizeDMAreq() {}
+        bool DMAactive() {return false;}
+        void handleDMA() {}
+    };
+
+    // mix of addressing modes, read-modify-write, stack and branch instructions
+    const uint8_t program[] = {
+        0xA2, 0x00,             // $8000  LDX #$00
+        0xBD, 0x00, 0x02,       // $8002  LDA $0200,X
+        0x69, 0x03,             // $8005  ADC #$03
+        0x9D, 0x00, 0x03,       // $8007  STA $0300,X
+        0x06, 0x10,             // $800A  ASL $10
+        0xFE, 0x00, 0x02,       // $800C  INC $0200,X
+        0xA0, 0x05,             // $800F  LDY #$05
+        0x51, 0x20,             // $8011  EOR ($20),Y
+        0x20, 0x1C, 0x80,       // $8013  JSR $801C
+        0xE8,                   // $8016  INX
+        0xD0, 0xE9,             // $8017  BNE $8002
+        0x4C, 0x00, 0x80,       // $8019  JMP $8000
+        0xC5, 0x11,             // $801C  CMP $11
+        0x6A,                   // $801E  ROR A
+        0x60                    // $801F  RTS
+    };
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t cycles = (argc > 1)? std::strtoull(argv[1], nullptr, 10) : 100000000;
+
+    FlatMemory *mem = new FlatMemory();
+    for (unsigned int i = 0; i < sizeof(program); i++)
+        mem->cpuMemory[0x8000 + i] = program[i];
+    mem->cpuMemory[0x0020] = 0xF0;      // ($20) points to $04F0 so ($20),Y crosses a page
+    mem->cpuMemory[0x0021] = 0x04;
+    mem->cpuMemory[0xFFFC] = 0x00;      // reset vector
+    mem->cpuMemory[0xFFFD] = 0x80;
+
+    ricoh2A03::CPU<NES::Memory> cpu(mem);
+    cpu.rst();
+
+    auto begin = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < cycles; i++)
+        cpu.tick(true);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cout << "cycles:           " << cpu.getClock() << std::endl;
+    std::cout << "instructions:     " << cpu.getInstructions() << std::endl;
+    std::cout << "seconds:          " << std::fixed << std::setprecision(3) << elapsed << std::endl;
+    std::cout << "instructions/sec: " << std::fixed << std::setprecision(0) << ((elapsed > 0.0)? ((double)(cpu.getInstructions()) / elapsed) : 0.0) << std::endl;
+    uint32_t ramSum = 0;
+    for (int i = 0; i < 0x0800; i++)
+        ramSum = (ramSum * 31) + mem->cpuMemory[i];
+    std::cout << "state:            " << std::hex << std::setfill('0') << std::setw(2) << (int)(cpu.ACC) << ' ' << std::setw(2) << (int)(cpu.REGX) << ' '
+              << std::setw(2) << (int)(cpu.REGY) << ' ' << std::setw(2) << (int)(cpu.STATUS) << ' ' << std::setw(8) << ramSum << std::endl;    // should match between cores
+    delete mem;
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include "include/Console.hpp"
+#include "include/Headless.hpp"
+
+// runs the emulator without SDL for a fixed number of frames, as fast as possible
+// usage: NES_Headless <ROM_path> <frames> [input_file]
+
+int main(int argc, char **argv)
+{
+    if ((argc != 3) && (argc != 4))
+    {
+        std::cout << "usage: " << argv[0] << " <ROM_path> <frames> [input_file]" << std::endl << "exiting" << std::endl;
+        return 1;
+    }
+    std::string ROMfile = std::string(argv[1]);
+    uint64_t frames = std::strtoull(argv[2], nullptr, 10);
+
+    NES::InputScript inputs;
+    if ((argc == 4) && !inputs.load(std::string(argv[3])))
+        return 1;
+
+    NES::HeadlessIO io;
+    NES::Console console(&io, &io);
+    if (!console.initCartridge(ROMfile))
+    {
+        std::cout << "unable to load cartridge " << ROMfile << std::endl << "exiting" << std::endl;
+        return 1;
+    }
+    console.rst();
+
+    auto begin = std::chrono::steady_clock::now();
+    for (uint64_t frame = 0; frame < frames; frame++)
+    {
+        console.controllerWrite(0, inputs.controllerState(frame, 0));
+        console.controllerWrite(1, inputs.controllerState(frame, 1));
+        console.runFrame();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cout << "frames:       " << io.framesDisplayed() << std::endl;
+    std::cout << "seconds:      " << std::fixed << std::setprecision(3) << elapsed << std::endl;
+    std::cout << "frames/sec:   " << std::fixed << std::setprecision(1) << ((elapsed > 0.0)? ((double)(io.framesDisplayed()) / elapsed) : 0.0) << std::endl;
+    std::cout << "samples:      " << io.samplesReceived() << std::endl;
+    std::cout << "frame hash:   " << std::hex << std::setw(8) << std::setfill('0') << io.frameHash() << std::endl;
+    std::cout << "video hash:   " << std::hex << std::setw(8) << std::setfill('0') << io.videoHash() << std::endl;
+    std::cout << "audio hash:   " << std::hex << std::setw(8) << std::setfill('0') << io.audioHash() << std::endl;
+    return 0;
+}
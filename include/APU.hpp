@@ -3,17 +3,22 @@
 
 #define USE_LOOKUP_TABLE 1
 #define USE_LINEAR_APPROX 0
-#define USE_FILTER 0
+
+#define APU_SAMPLE_BATCH    2048    // samples held before handing them to the audio sink (a frame is about 735 at 44.1kHz)
+#define APU_BLIP_PHASES     32      // fractional positions between output samples of the band-limited step kernel
+#define APU_BLIP_TAPS       32      // band-limited step kernel width in output samples (multiple of 16 for the vectorised versions)
 
 #include <cstdint>
 #include <cmath>
-#include "../include/IO.hpp"
+#include <cstring>
+#include "../include/Sink.hpp"
 #include <iostream>
 
 namespace NES
 {
-    class IO;
+    class AudioSink;
     class Memory;
+    class Scheduler;
 }
 
 namespace ricoh2A03
@@ -128,6 +133,22 @@ namespace ricoh2A03
                 regs.timerLow.set((uint8_t)(val & 0x00FF));
             }
 
+            // run the sequencer for many timer clocks at once (while silent, or when no step is reached)
+            void advanceTimer(uint32_t clocks)
+            {
+                if (clocks <= sequenceTimer)
+                {
+                    sequenceTimer -= clocks;
+                    return;
+                }
+                clocks -= sequenceTimer + 1;    // first reload
+                uint32_t period = (uint32_t)(getSequencePeriod()) + 1;
+                uint8_t steps = (1 + (clocks / period)) & 0x07;
+                sequenceTimer = getSequencePeriod() - (clocks % period);
+                if (steps)
+                    sequenceValue = (sequenceValue >> steps) | (sequenceValue << (8 - steps));
+            }
+
             // output 0x00-0x0F || (getSequencePeriod() < 8)
             uint8_t sample()
             {
@@ -243,6 +264,25 @@ namespace ricoh2A03
             // length unit
             uint8_t lengthCounter = 0;
 
+            // shift the random unit once
+            void shiftRandom()
+            {
+                uint16_t xorBitmask = (regs.loopNoise())? 0x0020 : 0x0002;
+                randomValue = (((randomValue & xorBitmask) ^ ((randomValue & 0x0001)? xorBitmask : 0x0000))? 0x4000 : 0x0000) | (randomValue >> 1);
+            }
+
+            // run the random unit for many timer clocks at once (while silent, or when no shift is reached)
+            void advanceTimer(uint32_t clocks)
+            {
+                while (clocks > randomTimer)
+                {
+                    clocks -= randomTimer + 1;
+                    randomTimer = randomPeriodTable[regs.noisePeriod()];
+                    shiftRandom();
+                }
+                randomTimer -= clocks;
+            }
+
             // output 0x00-0x0F
             uint8_t sample()
             {
@@ -354,77 +394,60 @@ namespace ricoh2A03
             0x20, 0x1E
         };
 
-        // "https://forums.nesdev.org/viewtopic.php?t=8602"
-        // heavy aliasing as original NES outputs at 1.8MHz, and we sample much less than that
-        // use low-pass filter to downsample audio to 1/2 frequency of sampling rate
-        // lowpass FIR filter @ 22.05kHz
-        // window-sinc method (impulse response calculation and windowing ripped from "https://rjeschke.tumblr.com/post/8382596050/fir-filters-in-practice")
-        #if USE_FILTER
-            struct lowpassFilter
+        // band-limited step synthesis ("http://www.slack.net/~ant/bl-synth/"), which is also the filter that decimates to the output rate
+        // (heavy aliasing otherwise, as the NES outputs at 1.8MHz, see "https://forums.nesdev.org/viewtopic.php?t=8602")
+        // the mixer output only changes when a channel steps, so rather than point-sampling it every tick, each change is added here
+        // as a band-limited step at its (fractional) output sample position; samples are then produced in bulk by integrating the buffer
+        // kernel is a windowed sinc precomputed for each phase, in fixed point so steps add up exactly (added with SIMD where the CPU allows)
+        struct blipBuffer
+        {
+            enum
             {
-                #define order 200
-
-                #define cutoff_freq 20000.0f    // (keep this under 22050.0f)
-                #define sample_rate 44100.0f
-
-                #define sinc(x) ((x != 0.0f)? (sin(x * M_PI) / (x * M_PI)) : 1.0f)
+                phases = APU_BLIP_PHASES,
+                taps = APU_BLIP_TAPS,               // (output is delayed by half of this)
+                size = APU_SAMPLE_BATCH + taps,
+                levelBits = 6,                      // fraction bits of mixer output (0-255) in deltas
+                kernelBits = 15                     // fraction bits of kernel coefficients (each phase sums to exactly 1 << kernelBits)
+            };
 
-                lowpassFilter()
+            blipBuffer()
+            {
+                if (!kernelInit)
                 {
-                    if (!impulseResponseInit)
+                    kernelInit = true;
+                    double cutoff = 0.45;           // fraction of the output sample rate
+                    for (int p = 0; p < phases; p++)
                     {
-                        impulseResponseInit = true;
-                        // maxAmplitude = 0.0f;
-                        double cutoff = cutoff_freq / sample_rate;
-                        double factor = 2.0f * cutoff;
-                        int32_t half = order >> 1;
-                        for(int i = 0; i <= order; i++)
+                        double impulse[taps];
+                        double sum = 0.0f;
+                        for (int k = 0; k < taps; k++)
                         {
-                            impulseResponse[i] = factor * sinc(factor * (i - half));                                                                                                    // sinc() impulse response w/ no windowing
-                            // std::cout << factor * sinc(factor * (i - half)) << std::endl;
-                            impulseResponse[i] *= (0.42f - (0.5f * cos(2.0f * M_PI * (double)(i) / (double)(order))) + (0.08f * cos(4.0f * M_PI * (double)(i) / (double)(order))));     // applying Blackman window
-                            // std::cout << (0.42f - (0.5f * cos(2.0f * M_PI * (double)(i) / (double)(order))) + (0.08f * cos(4.0f * M_PI * (double)(i) / (double)(order)))) << std::endl;
-                            std::cout << impulseResponse[i] << std::endl;
-                            // maxAmplitude += (255.0f * impulseResponse[i] * ((impulseResponse[i] >= 0.0f)? 1.0f : -1.0f));
+                            double x = (double)(k - (taps >> 1)) - ((double)(p) / (double)(phases));
+                            double window = (fabs(x) < (taps >> 1))? (0.42f + (0.5f * cos(2.0f * M_PI * x / taps)) + (0.08f * cos(4.0f * M_PI * x / taps))) : 0.0f;    // Blackman window
+                            impulse[k] = ((x != 0.0f)? (sin(2.0f * M_PI * cutoff * x) / (M_PI * x)) : (2.0f * cutoff)) * window;
+                            sum += impulse[k];
                         }
-                        // std::cout << maxAmplitude << std::endl;
+                        int32_t total = 0;
+                        for (int k = 0; k < taps; k++)
+                        {
+                            kernel[p][k] = (int16_t)(lround((impulse[k] / sum) * (1 << kernelBits)));
+                            total += kernel[p][k];
+                        }
+                        kernel[p][taps >> 1] += (int16_t)((1 << kernelBits) - total);   // rounding goes to the centre so every step settles on exactly its delta
                     }
                 }
+            }
 
-                ~lowpassFilter() {}
+            ~blipBuffer() {}
 
-                inline static bool impulseResponseInit = false;
-                inline static double impulseResponse[order + 1];    // for convolution
-                // inline static double maxAmplitude = 0.0f;
-                uint8_t sampleBuffer[order + 1] = {0};
-                uint8_t currIndex = 0;
+            inline static bool kernelInit = false;
+            inline static int16_t kernel[phases][taps];
+            int32_t buffer[size] = {0};
+            int32_t integrator = 0;
 
-                uint8_t processSample(uint8_t sample)
-                {
-                    sampleBuffer[currIndex++] = sample;
-                    if (currIndex > order)
-                        currIndex = 0;
-                    double result = 0.0f;
-                    int convIndex = currIndex;
-                    for (int i = 0; i <= order; i++)
-                    {
-                        convIndex--;
-                        if (convIndex < 0)
-                            convIndex = order;
-                        result += impulseResponse[i] * (double)(sampleBuffer[convIndex]);
-                    }
-                    return (result > 0.0f)? (uint8_t)(floor(result)) : 0x00;
-                    // std::cout << result << std::endl;
-                    // return (result > 0.0f)? (uint8_t)((result / maxAmplitude) * 255.0f) : 0x00;
-                    // return (uint8_t)(result);
-                }
-
-                #undef order
-                #undef cutoff_freq
-                #undef sample_rate
-                #undef sinc
-            } LowpassFilter;
-        #endif
+            void addDelta(double time, int16_t delta);      // time is in output samples since the last read (must be below APU_SAMPLE_BATCH)
+            void readSamples(uint8_t *out, uint32_t count);
+        } BlipBuffer;
 
         #if USE_LOOKUP_TABLE
             inline static double pulseTable[31] = {0};
@@ -432,8 +455,9 @@ namespace ricoh2A03
         #endif
 
     public:
-        APU(NES::Memory *m, NES::IO *io) : mem(m), IO(io), samplesPerTick(((double)(io->audioSampleRate()) * 1.5f) / (((341 * 262 * 2) - 1.0f) * 60.0f * 0.5f))
+        APU(NES::Memory *m, NES::AudioSink *a, NES::Scheduler *s) : mem(m), audio(a), scheduler(s), samplesPerTick(((double)(a->audioSampleRate()) * 1.5f) / (((341 * 262 * 2) - 1.0f) * 60.0f * 0.5f))
         {
+            blipClockLimit = (uint32_t)((double)(APU_SAMPLE_BATCH - 1) / samplesPerTick);
             #if USE_LOOKUP_TABLE
                 pulseTable[0] = 0.0f;
                 for (int i = 1; i < 31; i++)
@@ -446,6 +470,7 @@ namespace ricoh2A03
                     tndTable[i] = 163.67f / ((24329.0f / (double)(i)) + 100);
                 }
             #endif
+            scheduleSync();
         }
 
         ~APU() {}
@@ -453,21 +478,43 @@ namespace ricoh2A03
         uint8_t cpuRead(uint16_t addr);
         bool cpuWrite(uint16_t addr, uint8_t data);
 
-        void tick();
+        void catchUp();         // APU only runs when observed (register accesses, end of frame) or when it has something due for the CPU
+        void flushSamples();    // hand the samples generated so far to the audio sink in one call (end of each frame)
 
         bool irqReq() {return IRQ;}
         void irqReset() {IRQ = false;}
 
-        uint8_t DMCReaderDelay() { return ((DMCChannel.readerDelay)? DMCChannel.readerDelay-- : 0); }
+        uint8_t DMCReaderDelay() { return DMCChannel.readerDelay; }     // CPU cycles stalled by a DMC fetch
 
     private:
         // reader unit operation (called only if sampleBuffer is empty and readerBytesRemaining is not 0)
         void DMCReaderFetch();
 
+        // mixer output (0-255) of the channels' current levels
+        double mixerOutput();
+
+        // event-driven operation: ticks where a channel steps, the frame sequencer runs or the sample buffer fills are run one by one
+        // through tick(), and the (idle) ticks in between are skipped in one go
+        void tick();
+        uint32_t idleTicks();               // ticks until the next one that has to run through tick()
+        void skipTicks(uint32_t ticks);
+        void scheduleSync();                // main loop catches the APU up for the next frame IRQ or DMC fetch
+        void generateSamples();
+
         NES::Memory *mem = nullptr;
-        NES::IO *IO = nullptr;
+        NES::AudioSink *audio = nullptr;
+        NES::Scheduler *scheduler = nullptr;
+
+        uint64_t clock = 0;                             // ticks run so far
+
+        double samplesToGenerateOffset = 0.0f;         // fraction of an output sample carried over from the last flush
+        uint8_t sampleBatch[APU_SAMPLE_BATCH] = {0};
 
-        double samplesToGenerateOffset = 0.0f;
+        // band-limited output (mixer output is only re-evaluated when a channel may have stepped)
+        int32_t outputLevel = 0;                        // mixer output last added to BlipBuffer (fixed point, see blipBuffer::levelBits)
+        bool outputChanged = false;
+        uint32_t blipClock = 0;                         // ticks since the last flush
+        uint32_t blipClockLimit = 0;                    // ticks that fit in the buffer before a flush is forced
 
         uint8_t statusReg = 0x00;                       // $4015 (IF-DNT21) (channel length counter enable flags)
         uint8_t frameCounterReg = 0x00;                 // $4017
@@ -0,0 +1,328 @@
+#ifndef _BUS
+#define _BUS
+
+#include <cstdint>
+#include "../include/Memory.hpp"
+#include "../include/Mapper.hpp"
+#include "../include/Ricoh2A03.hpp"
+#include "../include/Ricoh2C02.hpp"
+#include "../include/APU.hpp"
+#include "../include/Scheduler.hpp"
+
+namespace NES
+{
+    // memory map composed for one mapper type (instantiated when the cartridge loads; see NES::Console::initCartridge())
+    // the CPU and PPU are templated on it so reads and writes (and the mapper calls behind them) are direct calls that can be inlined
+    template<class MapperT>
+    class Bus final : public Memory
+    {
+    public:
+        Bus(MapperT *m, Scheduler *s);
+        ~Bus();
+
+        uint8_t cpuRead(uint16_t addr);
+        bool cpuWrite(uint16_t addr, uint8_t data);
+
+        uint8_t ppuRead(uint16_t addr);
+        bool ppuWrite(uint16_t addr, uint8_t data);
+        const uint16_t *ppuTile(uint16_t addr);     // pattern fetch from 0x0000 - 0x1FFF as a decoded row (see NES::Mapper::chrTile())
+
+        #ifdef DEBUG
+            uint8_t cpuReadDebug(uint16_t addr);
+            uint8_t ppuReadDebug(uint16_t addr);
+        #endif
+
+        void connect(ricoh2A03::CPU<Bus> *c, ricoh2C02::PPU<Bus> *p, ricoh2A03::APU *a);
+
+        uint8_t controllerRead(uint8_t player);
+        void controllerWrite(uint8_t player, uint8_t data);
+
+        void mapperIrqReset();
+        bool mapperWatchesA12();
+        void ppuRequestDMA();
+        void finalizeDMAreq();
+        bool DMAactive();
+        void handleDMA();
+
+    private:
+        uint8_t *cpuMemory = nullptr;   // modifiable cpu memory 0x0000 - 0x401F
+        MapperT *mapper = nullptr;      // mapper for interface to CPU memory 0x4020 - 0xFFFF and PPU memory 0x0000-0x1FFF
+
+        // CPU address decoding per 256 byte page: plain memory (RAM, cartridge RAM, PRG ROM) is one indexed load or store
+        // nullptr pages (PPU/APU/IO registers and mapper registers) go through the handlers below; the mapper keeps its own pages current
+        uint8_t *readPage[0x100];
+        uint8_t *writePage[0x100];
+
+        // PPU address decoding per 1kB below 0x3F00 (pattern tables and nametables, with bank switching and mirroring resolved by the mapper)
+        uint8_t *ppuPage[0x10];
+
+        ricoh2A03::CPU<Bus> *cpu = nullptr;
+        ricoh2C02::PPU<Bus> *ppu = nullptr;
+        ricoh2A03::APU *apu = nullptr;
+
+        Scheduler *scheduler = nullptr;     // for OAM DMA requests
+
+        uint8_t controllerBuffer1 = 0x00;   // buffered input for controller
+        uint8_t controllerBuffer2 = 0x00;   // buffered input for controller
+
+        // helper variables for DMA
+        bool reqDMA = false;            // ppu requesting DMA
+        uint16_t DMAcycles = 0;         // 256 consecutive writes in a page (512 cpu cycles for reads and writes + 1 idle cycle + 1 idle cycle if beginning on odd cpu cycle)
+    };
+};
+
+
+
+template<class MapperT>
+NES::Bus<MapperT>::Bus(MapperT *m, NES::Scheduler *s) : mapper(m), scheduler(s)
+{
+    cpuMemory = new uint8_t[0x401F]{0};
+    for (uint16_t page = 0; page < 0x100; page++)
+    {
+        readPage[page] = (page < 0x20)? (cpuMemory + ((page & 0x07) << 8)) : nullptr;    // 0x0000 - 0x1FFF mirrors 2kB of RAM
+        writePage[page] = readPage[page];
+    }
+    mapper->attachPages(readPage, writePage, ppuPage);
+    mapper->updatePages();
+}
+
+template<class MapperT>
+NES::Bus<MapperT>::~Bus()
+{
+    delete[] cpuMemory;
+    delete mapper;
+}
+
+template<class MapperT>
+inline uint8_t NES::Bus<MapperT>::cpuRead(uint16_t addr)
+{
+    if (const uint8_t *page = readPage[addr >> 8])
+        return page[addr & 0x00FF];
+    else if (addr <= 0x3FFF)        // remember to update PPU latch
+    {
+        ppu->catchUp();             // PPU only runs when observed
+        return ppu->cpuRead(addr);
+    }
+    else if (addr <= 0x4015)
+    {
+        if (addr == 0x4014)
+        {
+            ppu->catchUp();
+            return ppu->cpuRead(addr);
+        }
+        else if (addr == 0x4015)
+        {
+            apu->catchUp();         // APU only runs when observed
+            return apu->cpuRead(addr);
+        }
+        return 0x00;
+    }
+    else if (addr <= 0x4017)        // controller serial read
+    {
+        uint8_t data = (cpuMemory[addr] & 0x80)? 1 : 0;
+        cpuMemory[addr] <<= 1;
+        return data;
+    }
+    else if (addr <= 0x401F)
+        return cpuMemory[addr];
+    else
+        return mapper->cpuRead(addr);
+}
+
+template<class MapperT>
+inline bool NES::Bus<MapperT>::cpuWrite(uint16_t addr, uint8_t data)
+{
+    if (uint8_t *page = writePage[addr >> 8])
+    {
+        page[addr & 0x00FF] = data;
+        return true;
+    }
+    else if (addr <= 0x3FFF)
+    {
+        ppu->catchUpForWrite();
+        return ppu->cpuWrite(addr, data);
+    }
+    else if (addr <= 0x401F)
+    {
+        if (addr <= 0x4013)
+        {
+            apu->catchUp();
+            return apu->cpuWrite(addr, data);
+        }
+        else if (addr == 0x4014)
+        {
+            ppu->catchUpForWrite();
+            return ppu->cpuWrite(addr, data);
+        }
+        else if ((addr == 0x4015) || (addr == 0x4017))
+        {
+            apu->catchUp();
+            return apu->cpuWrite(addr, data);
+        }
+        else if (addr == 0x4016)                            // write 1 to $4016 to signal controller to poll input, then 0 to stop poll
+        {                                                   // read polled data one bit at a time from $4016 or $4017
+            if (data == 0x01)
+            {
+                cpuMemory[0x4016] = controllerBuffer1;
+                cpuMemory[0x4017] = controllerBuffer2;
+            }
+        }
+        else
+            cpuMemory[addr] = data;
+        return true;
+    }
+    else
+    {
+        if (addr >= 0x8000)         // mapper registers (bank switching and mirroring change what the PPU fetches)
+            ppu->catchUpForWrite();
+        return mapper->cpuWrite(addr, data);
+    }
+}
+
+template<class MapperT>
+inline uint8_t NES::Bus<MapperT>::ppuRead(uint16_t addr)
+{
+    addr &= 0x3FFF;
+    if (addr <= 0x3EFF)
+    {
+        mapper->ppuFetch(addr);
+        return ppuPage[addr >> 10][addr & 0x03FF];
+    }
+    else
+        return ppu->paletteRead(addr);          // palette RAM is inside the PPU
+}
+
+template<class MapperT>
+inline const uint16_t *NES::Bus<MapperT>::ppuTile(uint16_t addr)
+{
+    mapper->ppuFetch(addr);
+    return mapper->chrTile(addr);
+}
+
+template<class MapperT>
+inline bool NES::Bus<MapperT>::ppuWrite(uint16_t addr, uint8_t data)
+{
+    addr &= 0x3FFF;
+    if (addr <= 0x1FFF)
+        return mapper->ppuWrite(addr, data);            // get from cartridge
+    else if (addr <= 0x3EFF)
+        return mapper->ppuWrite((addr & 0x2FFF), data); // need nametable mirroring
+    else
+    {
+        ppu->paletteWrite(addr, data);                  // palette RAM is inside the PPU
+        return true;
+    }
+}
+
+#ifdef DEBUG
+    template<class MapperT>
+    uint8_t NES::Bus<MapperT>::cpuReadDebug(uint16_t addr)
+    {
+        if (addr <= 0x1FFF)
+            return cpuMemory[addr & 0x07FF];
+        else if (addr <= 0x3FFF)
+            return ppu->cpuReadDebug(addr);
+        else if (addr <= 0x4015)
+        {
+            if (addr == 0x4014)
+                return ppu->cpuReadDebug(addr);
+            return cpuMemory[addr];
+        }
+        else if (addr <= 0x4017)
+            return cpuMemory[addr];
+        else if (addr <= 0x401F)
+            return cpuMemory[addr];
+        else
+            return mapper->cpuReadDebug(addr);
+    }
+
+    template<class MapperT>
+    uint8_t NES::Bus<MapperT>::ppuReadDebug(uint16_t addr)
+    {
+        addr &= 0x3FFF;
+        if (addr <= 0x1FFF)
+            return mapper->ppuReadDebug(addr);
+        else if (addr <= 0x3EFF)
+            return mapper->ppuReadDebug(addr & 0x2FFF);
+        else
+            return ppu->paletteRead(addr);
+    }
+#endif
+
+template<class MapperT>
+void NES::Bus<MapperT>::connect(ricoh2A03::CPU<Bus> *c, ricoh2C02::PPU<Bus> *p, ricoh2A03::APU *a)
+{
+    cpu = c;
+    ppu = p;
+    apu = a;
+}
+
+template<class MapperT>
+uint8_t NES::Bus<MapperT>::controllerRead(uint8_t player)
+{
+    if (!player)
+        return controllerBuffer1;
+    return controllerBuffer2;
+}
+
+template<class MapperT>
+void NES::Bus<MapperT>::controllerWrite(uint8_t player, uint8_t data)
+{
+    if (!player)
+        controllerBuffer1 = data;
+    else
+        controllerBuffer2 = data;
+}
+
+
+
+template<class MapperT>
+void NES::Bus<MapperT>::mapperIrqReset()
+{
+    mapper->IRQreset();
+}
+
+template<class MapperT>
+inline bool NES::Bus<MapperT>::mapperWatchesA12()
+{
+    return mapper->A12watched();
+}
+
+template<class MapperT>
+void NES::Bus<MapperT>::ppuRequestDMA()
+{
+    reqDMA = true;
+    scheduler->raise(NES::oamDma);
+}
+
+template<class MapperT>
+void NES::Bus<MapperT>::finalizeDMAreq()
+{
+    if(reqDMA)
+        DMAcycles = 513;
+    reqDMA = false;
+}
+
+template<class MapperT>
+inline bool NES::Bus<MapperT>::DMAactive()
+{
+    return (DMAcycles > 0);
+}
+
+template<class MapperT>
+void NES::Bus<MapperT>::handleDMA()
+{
+    if (DMAcycles > 0)
+    {
+        if ((DMAcycles == 513) && (cpu->getClock() & 0x01)) // extra idle cycle for odd cpu cycles
+            return;
+        if ((DMAcycles < 513) && (DMAcycles & 0x0001))      // takes into account idle cycle at beginning; also only happens on write cycles
+        {
+            ppu->catchUpForWrite();
+            ppu->DMAtransfer();
+        }
+        DMAcycles--;
+    }
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef _CONSOLE
+#define _CONSOLE
+
+#include <cstdint>
+#include <string>
+#include "../include/Bus.hpp"
+#include "../include/Sink.hpp"
+#include "../include/Scheduler.hpp"
+
+namespace NES
+{
+    class Cartridge;
+
+    // the emulated hardware behind a Console (only called into once per frame, so the chips themselves can be composed per mapper)
+    class System
+    {
+    public:
+        virtual ~System(){};
+
+        virtual void rst() = 0;
+        virtual void runFrame() = 0;
+        virtual void controllerWrite(uint8_t player, uint8_t data) = 0;
+        virtual uint8_t* const getScreen() = 0;
+        virtual uint8_t* const getScreenIndices() = 0;
+
+        #ifdef DEBUG
+            virtual uint8_t* const getChrROM() = 0;
+            virtual uint8_t* const getOAM() = 0;
+            virtual uint8_t* const getNT() = 0;
+            virtual void enableLog(bool enable) = 0;
+        #endif
+    };
+
+    // CPU, PPU and APU wired to the bus of one mapper type and stepped by the event scheduler
+    template<class MapperT>
+    class NESsystem final : public System
+    {
+    public:
+        NESsystem(Cartridge *c, AudioSink *a);
+        ~NESsystem(){};
+
+        void rst();
+        void runFrame();    // emulate until PPU completes a frame
+        void controllerWrite(uint8_t player, uint8_t data) {bus.controllerWrite(player, data);}
+        uint8_t* const getScreen() {return ppu.getScreen();}
+        uint8_t* const getScreenIndices() {return ppu.getScreenIndices();}
+
+        #ifdef DEBUG
+            uint8_t* const getChrROM() {return ppu.getChrROM();}
+            uint8_t* const getOAM() {return ppu.getOAM();}
+            uint8_t* const getNT() {return ppu.getNT();}
+            void enableLog(bool enable) {cpu.enableLog(enable);}
+        #endif
+
+        Scheduler scheduler;
+        Bus<MapperT> bus;
+        ricoh2A03::CPU<Bus<MapperT>> cpu;
+        ricoh2C02::PPU<Bus<MapperT>> ppu;
+        ricoh2A03::APU apu;
+
+    private:
+        uint8_t dmcStall = 0;   // CPU cycles left to skip for the last DMC fetch
+
+        bool handleEvents();        // slow path for a CPU cycle; true if the frame ended instead
+    };
+
+    // loads a cartridge into the NESsystem for its mapper and hands out finished frames (no SDL dependency)
+    class Console
+    {
+    public:
+        Console(VideoSink *v, AudioSink *a);
+        ~Console();
+
+        bool initCartridge(std::string filename);     // false if the ROM could not be read or parsed
+        void rst();
+
+        void runFrame();    // emulate until PPU completes a frame, then hand the screen to the video sink
+
+        void controllerWrite(uint8_t player, uint8_t data);
+
+        #ifdef DEBUG
+            uint8_t* const getChrROM() {return system->getChrROM();}
+            uint8_t* const getOAM() {return system->getOAM();}
+            uint8_t* const getNT() {return system->getNT();}
+            void enableLog(bool enable) {system->enableLog(enable);}
+        #endif
+
+    private:
+        System *system = nullptr;
+        VideoSink *video = nullptr;
+        AudioSink *audio = nullptr;
+    };
+}
+
+#endif
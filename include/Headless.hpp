@@ -0,0 +1,64 @@
+#ifndef _HEADLESS
+#define _HEADLESS
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../include/Sink.hpp"
+
+#define HEADLESS_SAMPLE_RATE    44100
+
+namespace NES
+{
+    // sinks that discard output but keep a running hash (for comparing runs without a display or sound device)
+    class HeadlessIO : public VideoSink, public AudioSink
+    {
+    public:
+        HeadlessIO();
+        ~HeadlessIO();
+
+        void displayScreen(uint8_t *screen);
+        bool wantsRGB() {return false;}     // hashes the palette indices, so frames are never converted to RGB
+        void audioAddSamples(const uint8_t *samples, uint32_t count);
+        int audioSampleRate() {return HEADLESS_SAMPLE_RATE;}
+
+        uint32_t frameHash() {return lastFrameHash;}    // FNV-1a hash of the most recent frame (its 256 x 240 palette indices)
+        uint32_t videoHash() {return allFramesHash;}    // FNV-1a hash of every frame hash so far
+        uint32_t audioHash() {return sampleHash;}       // FNV-1a hash of every sample so far
+        uint64_t framesDisplayed() {return frameCount;}
+        uint64_t samplesReceived() {return sampleCount;}
+
+    private:
+        uint32_t lastFrameHash = 0;
+        uint32_t allFramesHash = 2166136261u;
+        uint32_t sampleHash = 2166136261u;
+        uint64_t frameCount = 0;
+        uint64_t sampleCount = 0;
+    };
+
+    // controller input script
+    // each line is "<frame> <player 1 hex> [<player 2 hex>]"; buttons are held until a later line changes them
+    // ('#' starts a comment; bit order matches IO: A, B, SELECT, START, UP, DOWN, LEFT, RIGHT from MSB)
+    class InputScript
+    {
+    public:
+        InputScript(){};
+        ~InputScript(){};
+
+        bool load(std::string filename);
+        uint8_t controllerState(uint64_t frame, uint8_t player);
+
+    private:
+        struct Entry
+        {
+            uint64_t frame;
+            uint8_t data[2];
+        };
+
+        std::vector<Entry> entries;     // sorted by frame
+        size_t nextEntry = 0;
+        uint8_t current[2] = {0x00, 0x00};
+    };
+}
+
+#endif
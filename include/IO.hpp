@@ -10,17 +10,18 @@
 
 #define AUDIO_LATENCY_SAMPLES   (44100 / 20)    // 1/20 second of latency -> 1/20 * 44100 samples of latency
 #define AUDIO_FRAME_SAMPLES     1024
+#define AUDIO_RING_SAMPLES      8192            // sound ring size (power of 2 above the AUDIO_LATENCY_SAMPLES * 2 it is filled up to)
 
 #include <cstdint>
+#include <atomic>
+#include "../include/Sink.hpp"
 
 namespace NES
 {
-    class Memory;
-
-    class IO
+    class IO : public VideoSink, public AudioSink
     {
     public:
-        IO(Memory *m);
+        IO();
         ~IO();
 
         void displayScreen(uint8_t* screen);
@@ -32,8 +33,9 @@ namespace NES
         #endif
         
         void updateInputs(bool *quit, bool *pause, bool *log);
+        uint8_t controllerRead(uint8_t player) {return controllerState[player & 0x01];}
         
-        void audioAddSample(uint8_t sample);
+        void audioAddSamples(const uint8_t *samples, uint32_t count);
         void audioPause(bool p);
 
         static void audioCallback(void* userdata, uint8_t* stream, int len);
@@ -41,7 +43,7 @@ namespace NES
         int audioSampleRate();
 
     private:
-        Memory *mem;
+        uint8_t controllerState[2] = {0x00, 0x00};     // keyboard button states (A, B, SELECT, START, UP, DOWN, LEFT, RIGHT)
 
         SDL_Window *window0;
         SDL_Renderer *renderer0;
@@ -67,14 +69,15 @@ namespace NES
 
         SDL_Event event;
         
-        // SDL sound callback data (circular buffer)
-        inline static uint8_t soundBuffer[AUDIO_LATENCY_SAMPLES * 2] = {0};     // sound buffer
-        inline static int32_t soundBufferIndex = 0;                             // position of buffer write position
-        inline static int32_t soundBufferStart = 0;
-        inline static bool soundBufferLoop = false;
-
-        inline static bool audioPaused = true;              // explicit pause from game loop
-        inline static bool audioPlaybackPaused = true;      // brief pause from not enough samples in sound buffer
+        // SDL sound callback data (single producer/single consumer ring: emulation thread writes, SDL audio thread reads)
+        // both counts only move forward (wrapping at 2^32) and each is stored by one side only, on its own cache line
+        alignas(64) std::atomic<uint32_t> soundWritten{0};     // samples put in the ring so far (emulation thread)
+        alignas(64) std::atomic<uint32_t> soundRead{0};        // samples taken out of the ring so far (audio thread)
+        uint8_t soundLast = 0x00;                               // last sample played (repeated when the ring runs dry)
+        alignas(64) uint8_t soundBuffer[AUDIO_RING_SAMPLES] = {0};
+
+        bool audioPaused = true;            // explicit pause from game loop
+        bool audioPlaybackPaused = true;    // brief pause from not enough samples in sound buffer
     };
 }
 
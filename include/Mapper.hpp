@@ -2,15 +2,11 @@
 #define _Mapper
 
 #include <cstdint>
-#include <string>
-
-namespace ricoh2A03
-{
-    class CPU;
-}
 
 namespace NES
 {
+    class Scheduler;
+
     enum mirror     // https://wiki.nesdev.com/w/index.php/Mirroring#Nametable_Mirroring
     {
         horizontal,
@@ -26,7 +22,7 @@ namespace NES
     class Mapper
     {
     public:
-        Mapper(Cartridge *c);
+        Mapper(Cartridge *c, Scheduler *s);
         ~Mapper();
 
         const uint8_t mapperID;
@@ -44,6 +40,12 @@ namespace NES
 
         bool IRQcheck() {return IRQ;}
         void IRQreset() {IRQ = false;}
+        bool A12watched() {return A12watch;}    // PPU has to stay in step with the CPU while fetching patterns
+        void attachPages(uint8_t **r, uint8_t **w, uint8_t **p) {readPage = r; writePage = w; ppuPage = p;}   // CPU and PPU page tables owned by NES::Bus (filled in by updatePages())
+        void ppuFetch(uint16_t) {}              // called by NES::Bus for each PPU read through the page table (hidden by mappers that watch the PPU address lines)
+
+        // decoded pattern row for PPU 0x0000 - 0x1FFF (the plane bit 0x0008 is ignored): [0] as stored, [1] flipped horizontally (see chrTiles below)
+        const uint16_t *chrTile(uint16_t addr) {return chrTileSlot[addr >> 10] + ((((addr & 0x03F0) >> 1) | (addr & 0x0007)) << 1);}
 
     protected:
         Cartridge *cart;                // prgROM for CPU 0x8000 - 0xFFFF and chrROM for PPU 0x0000 - 0x1FFF
@@ -54,18 +56,43 @@ namespace NES
         mirror ntMirror = undefined;
         
         bool IRQ = false;
+        bool A12watch = false;          // mapper reacts to PPU address line A12 (scanline counters)
+        Scheduler *scheduler = nullptr; // for clock cycle counting and raising IRQ
+
+        uint8_t **readPage = nullptr;   // 256 entries, one per 256 byte CPU page (nullptr falls back to cpuRead())
+        uint8_t **writePage = nullptr;  // 256 entries, one per 256 byte CPU page (nullptr falls back to cpuWrite())
+        uint8_t **ppuPage = nullptr;    // 16 entries, one per 1kB of PPU 0x0000 - 0x3FFF (reads only; 0x3F00 - 0x3FFF is palette RAM in the PPU)
+        void mapPages(uint8_t **table, uint16_t first, uint16_t count, uint8_t *base);  // consecutive pages from base (nullptr unmaps)
+        void mapEXPROM(bool readable, bool writable);   // 0x4100 - 0x5FFF (0x4020 - 0x40FF shares a page with the APU and IO registers)
+        void mapSRAM(bool enabled);                     // 0x6000 - 0x7FFF
+
+        // resolved bank base pointers, rebuilt only when a bank register is written (reads are slot[addr >> 13][addr & 0x1FFF] and slot[addr >> 10][addr & 0x03FF])
+        uint8_t *prgSlot[4] = {nullptr, nullptr, nullptr, nullptr};     // 8kB slots for CPU 0x8000 - 0xFFFF
+        uint8_t *chrSlot[8] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};     // 1kB slots for PPU 0x0000 - 0x1FFF
+        void mapPrg(uint8_t slot, uint8_t count, uint8_t *base);   // consecutive 8kB slots from base
+        void mapChr(uint8_t slot, uint8_t count, uint8_t *base);   // consecutive 1kB slots from base
+        void mapPrgPages();                                         // publish prgSlot[] to the CPU page table
+        uint8_t *ntSlot[4] = {nullptr, nullptr, nullptr, nullptr};  // 1kB slots for PPU 0x2000 - 0x2FFF (mirrored at 0x3000 - 0x3EFF) pointing into NAMETABLE
+        void mapNametables(mirror m);                               // ntSlot[] for a mirroring mode
+        void mapPpuPages();                                         // publish chrSlot[] and ntSlot[] to the PPU page table
+
+        // CHR decoded to 2-bit pixels, one uint16_t per tile row with the leftmost pixel in bits 15-14 (pattern plane 1 over plane 0), followed by the row flipped horizontally
+        // laid out like cart->chrROM (1kB of CHR is 1024 entries), so bank switches only repoint chrTileSlot[] in mapChr(); CHR RAM writes go through writeChr() to redecode their row
+        uint32_t chrSize = 0;               // bytes of CHR ROM (or CHR RAM)
+        uint16_t *chrTiles = nullptr;
+        const uint16_t *chrTileSlot[8] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};  // 1kB slots matching chrSlot[]
+        void decodeChr(uint32_t offset);                // the tile row holding CHR byte offset
+        void writeChr(uint32_t offset, uint8_t data);   // CHR RAM write at a physical offset
     };
 
-
-
-    Mapper* createMapper(std::string filename, ricoh2A03::CPU *cpu);   // use this to initialize Mapper and internal Cartridge
+    // mappers are final so that NES::Bus<MapperN> calls them directly (see NES::Console::initCartridge() for creation)
 
 
 
-    class Mapper0 : public Mapper
+    class Mapper0 final : public Mapper
     {
     public:
-        Mapper0(Cartridge *c);
+        Mapper0(Cartridge *c, Scheduler *s);
         ~Mapper0();
         uint8_t cpuRead(uint16_t addr);
         bool cpuWrite(uint16_t addr, uint8_t data);
@@ -75,14 +102,17 @@ namespace NES
             uint8_t cpuReadDebug(uint16_t addr);
             uint8_t ppuReadDebug(uint16_t addr);
         #endif
+        void updatePages();     // refresh this mapper's entries in the CPU page table
+    private:
+        void updateBanks();     // rebuild prgSlot[] and chrSlot[] from the bank registers
     };
 
 
 
-    class Mapper1 : public Mapper
+    class Mapper1 final : public Mapper
     {
     public:
-        Mapper1(Cartridge *c);
+        Mapper1(Cartridge *c, Scheduler *s);
         ~Mapper1();
         uint8_t cpuRead(uint16_t addr);
         bool cpuWrite(uint16_t addr, uint8_t data);
@@ -92,7 +122,10 @@ namespace NES
             uint8_t cpuReadDebug(uint16_t addr);
             uint8_t ppuReadDebug(uint16_t addr);
         #endif
+        void updatePages();     // refresh this mapper's entries in the CPU page table
     private:
+        void updateBanks();     // rebuild prgSlot[] and chrSlot[] from the bank registers
+
         uint8_t regLoad = 0x00;     // shift register to load data into below registers
         uint8_t regCtrl = 0x1C;     // needed on startup for reading last PRG ROM bank
         uint8_t regChrBank0 = 0x00;
@@ -104,10 +137,10 @@ namespace NES
 
 
 
-    class Mapper2 : public Mapper
+    class Mapper2 final : public Mapper
     {
     public:
-        Mapper2(Cartridge *c);
+        Mapper2(Cartridge *c, Scheduler *s);
         ~Mapper2();
         uint8_t cpuRead(uint16_t addr);
         bool cpuWrite(uint16_t addr, uint8_t data);
@@ -117,16 +150,19 @@ namespace NES
             uint8_t cpuReadDebug(uint16_t addr);
             uint8_t ppuReadDebug(uint16_t addr);
         #endif
+        void updatePages();     // refresh this mapper's entries in the CPU page table
     private:
+        void updateBanks();     // rebuild prgSlot[] and chrSlot[] from the bank registers
+
         uint8_t regBankSelect = 0x00;
     };
 
 
 
-    class Mapper3 : public Mapper
+    class Mapper3 final : public Mapper
     {
     public:
-        Mapper3(Cartridge *c);
+        Mapper3(Cartridge *c, Scheduler *s);
         ~Mapper3();
         uint8_t cpuRead(uint16_t addr);
         bool cpuWrite(uint16_t addr, uint8_t data);
@@ -136,28 +172,34 @@ namespace NES
             uint8_t cpuReadDebug(uint16_t addr);
             uint8_t ppuReadDebug(uint16_t addr);
         #endif
+        void updatePages();     // refresh this mapper's entries in the CPU page table
     private:
+        void updateBanks();     // rebuild prgSlot[] and chrSlot[] from the bank registers
+
         uint8_t regBankSelect = 0x00;
     };
 
 
 
-    class Mapper4 : public Mapper
+    class Mapper4 final : public Mapper
     {
     public:
-        Mapper4(Cartridge *c, ricoh2A03::CPU *cpu);
+        Mapper4(Cartridge *c, Scheduler *s);
         ~Mapper4();
         uint8_t cpuRead(uint16_t addr);
         bool cpuWrite(uint16_t addr, uint8_t data);
         uint8_t ppuRead(uint16_t addr);
         bool ppuWrite(uint16_t addr, uint8_t data);
+        void ppuFetch(uint16_t addr) {updateIrqCounter(addr);}     // A12 watch for the scanline counter
 
         #ifdef DEBUG
             uint8_t cpuReadDebug(uint16_t addr);
             uint8_t ppuReadDebug(uint16_t addr);
         #endif
-
+        void updatePages();     // refresh this mapper's entries in the CPU page table
     private:
+        void updateBanks();     // rebuild prgSlot[] and chrSlot[] from the bank registers
+
         uint8_t regBankSelect = 0x00;
         // uint8_t regBankData = 0x00;      // update bankRegisters[]
         uint8_t regMirror = 0x00;
@@ -173,7 +215,6 @@ namespace NES
         bool A12down = false;               // PPU A12 (0x1000) needs to stay 0 for 3 CPU cycles before triggering irqCounter on rising edge
         uint64_t A12FirstDown = 0;          // cycle of 1st A12 down without being up (very small chance of overflow BS though)
 
-        ricoh2A03::CPU *cpu = nullptr;      // for clock cycle counting
 
         void updateIrqCounter(uint16_t addr);
 
@@ -2,29 +2,15 @@
 #define _MEMORY
 
 #include <cstdint>
-#include <string>
-
-namespace ricoh2A03
-{
-    class CPU;
-    class APU;
-}
-
-namespace ricoh2C02
-{
-    class PPU;
-}
 
 namespace NES
 {
-    class Memory    // for googletest
+    class Memory    // interface to the memory map (for googletest and the APU's DMC reads; the CPU and PPU are wired to a NES::Bus directly)
     {
     public:
         Memory(){};
         ~Memory(){};
 
-        virtual void initCartridge(std::string filename) = 0;
-
         virtual uint8_t cpuRead(uint16_t addr) = 0;
         virtual bool cpuWrite(uint16_t addr, uint8_t data) = 0;
 
@@ -36,74 +22,16 @@ namespace NES
             virtual uint8_t ppuReadDebug(uint16_t addr) = 0;
         #endif
 
-        virtual void connect(ricoh2A03::CPU *c, ricoh2C02::PPU *p, ricoh2A03::APU *a) = 0;
-
         virtual uint8_t controllerRead(uint8_t player) = 0;
         virtual void controllerWrite(uint8_t player, uint8_t data) = 0;
 
-        virtual bool mapperIrqReq() = 0;
         virtual void mapperIrqReset() = 0;
-        virtual void toggleCpuCycle() = 0;
+        virtual bool mapperWatchesA12() = 0;
         virtual void ppuRequestDMA() = 0;
         virtual void finalizeDMAreq() = 0;
         virtual bool DMAactive() = 0;
         virtual void handleDMA() = 0;
     };
-
-
-
-    class Mapper;
-
-    class NESmemory : public Memory
-    {
-    public:
-        NESmemory();
-        ~NESmemory();
-
-        void initCartridge(std::string filename);
-
-        uint8_t cpuRead(uint16_t addr);
-        bool cpuWrite(uint16_t addr, uint8_t data);
-
-        uint8_t ppuRead(uint16_t addr);
-        bool ppuWrite(uint16_t addr, uint8_t data);
-
-        #ifdef DEBUG
-            uint8_t cpuReadDebug(uint16_t addr);
-            uint8_t ppuReadDebug(uint16_t addr);
-        #endif
-
-        void connect(ricoh2A03::CPU *c, ricoh2C02::PPU *p, ricoh2A03::APU *a);
-
-        uint8_t controllerRead(uint8_t player);
-        void controllerWrite(uint8_t player, uint8_t data);
-
-        bool mapperIrqReq();
-        void mapperIrqReset();
-        void toggleCpuCycle();
-        void ppuRequestDMA();
-        void finalizeDMAreq();
-        bool DMAactive();
-        void handleDMA();
-    
-    private:
-        uint8_t *cpuMemory = nullptr;   // modifiable cpu memory 0x0000 - 0x401F
-        // uint8_t *ppuMemory = nullptr;   // PPU memory (64kB memory 0x0000 - 0xFFFF) (physically 16kB mirrored 0x0000 - 0x3FFF)
-        uint8_t *ppuPalette;            // memory for loading raw palette data
-        Mapper *mapper = nullptr;       // mapper for interface to CPU memory 0x4020 - 0xFFFF and PPU memory 0x0000-0x1FFF
-
-        ricoh2A03::CPU *cpu = nullptr;
-        ricoh2C02::PPU *ppu = nullptr;
-        ricoh2A03::APU *apu = nullptr;
-
-        uint8_t controllerBuffer1 = 0x00;   // buffered input for controller
-        uint8_t controllerBuffer2 = 0x00;   // buffered input for controller
-
-        // helper variables for DMA
-        bool cpuOddCycle = false;       // just for the sake of DMA delay on odd cpu cycles
-        bool reqDMA = false;            // ppu requesting DMA
-        uint16_t DMAcycles = 0;         // 256 consecutive writes in a page (512 cpu cycles for reads and writes + 1 idle cycle + 1 idle cycle if beginning on odd cpu cycle)
-    };
 };
 
 #endif
@@ -7,11 +7,6 @@
     #include <fstream>
 #endif
 
-namespace NES
-{
-    class Memory;
-};
-
 namespace ricoh2A03
 {
     enum statusMask
@@ -26,19 +21,51 @@ namespace ricoh2A03
         negativeFlag =      ((uint8_t)(1) << 7)
     };
 
+    // addressing modes (http://www.obelisk.me.uk/6502/addressing.html) (http://archive.6502.org/datasheets/rockwell_r650x_r651x.pdf)
+    enum addrMode
+    {
+        IMP,        // implied addressing
+        ACCUM,      // accumulator addressing
+        IMM,        // immediate address
+        ZP,         // zero page addressing
+        ZPX,        // indexed zero page addressing from regX
+        ZPY,        // indexed zero page addressing from regY
+        ABS,        // absolute addressing
+        ABSX,       // indexed absolute addressing from regX (potential +1 delay)
+        ABSY,       // indexed absolute addressing from regY (potential +1 delay)
+        IND,        // absolute indirect
+        INDX,       // indexed indirect addressing from regX
+        INDY,       // indexed indirect addressing from regY (potential +1 delay)
+        REL         // relative addressing (+1/+2 on success for branches)
+    };
+
+    // operations (http://6502.org/tutorials/6502opcodes.html) (http://www.obelisk.me.uk/6502/instructions.html)
+    // note: 56 official operations, then the unofficial ones prefixed with 'X' (http://wiki.nesdev.com/w/index.php/CPU_unofficial_opcodes) (http://www.oxyron.de/html/opcodes02.html)
+    enum instrOp
+    {
+        LDA, LDX, LDY, STA, STX, STY, TAX, TAY, TXA, TYA, TSX, TXS, PHA, PHP, PLA, PLP,
+        AND, EOR, ORA, BIT, ADC, SBC, CMP, CPX, CPY, INC, INX, INY, DEC, DEX, DEY,
+        ASL, LSR, ROL, ROR, JMP, JSR, RTS, BCC, BCS, BEQ, BMI, BNE, BPL, BVC, BVS,
+        CLC, CLD, CLI, CLV, SEC, SED, SEI, BRK, NOP, RTI,
+        XSLO, XRLA, XSRE, XRRA, XDCP, XISC,     // read-modify-write combined with ORA, AND, EOR, ADC, CMP and SBC
+        XSAX, XAHX, XSHX, XSHY, XTAS,           // stores (the last four AND the value with the high address byte + 1)
+        XLAX, XLXA, XLAS, XANC, XALR, XARR, XAXS, XXAA, XSBC, XNOP,
+        XSTP                                    // halts the CPU
+    };
+
+    // Bus is the memory the CPU is wired to (a NES::Bus for a given mapper, or the NES::Memory interface for gtests)
+    template<class Bus>
     class CPU
     {
         struct instruction
         {
-            uint8_t (ricoh2A03::CPU::*operate) (void);
-            uint8_t (ricoh2A03::CPU::*addrMode)(void);
+            uint8_t (CPU::*exec)(void); // addressing mode and operation in one handler (returns extra cycles for page crosses and taken branches)
             uint8_t cycles;
-            uint8_t pageDelay;          // "1" if page cross delay for all ABSX, ABSY, and INDY is present (if implemented), else "0"
             const char operation[5];
         };
 
     public:
-        CPU(NES::Memory *m);
+        CPU(Bus *m);
         ~CPU();
 
         // CPU registers
@@ -49,10 +76,19 @@ namespace ricoh2A03
         uint8_t REGY = 0x00;    // register Y
         uint8_t STATUS = 0x00;  // processor status register
 
-        // clock function to call for one clock cycle
-        void tick(bool functional);
+        // clock function to call for one clock cycle (an instruction does all its work on its first cycle; the rest only count down, inline)
+        void tick(bool functional)
+        {
+            clock++;
+            if (!functional)
+                return;
+            if (insClk == 0)
+                step();
+            insClk--;
+        }
 
         uint64_t getClock();
+        uint64_t getInstructions();     // instructions executed since reset (for benchmarking the interpreter core)
 
         // interrupt functions
         void rst();
@@ -68,15 +104,16 @@ namespace ricoh2A03
 
     private:
         // memory interface for addresses up to 2^16
-        NES::Memory *mem = nullptr;
+        Bus *mem = nullptr;
 
         // remaining duration of current instruction
         uint8_t insClk = 0;
 
-        // current operation and subparts to total operation duration
+        // starts the next instruction (or interrupt) and sets insClk to its duration
+        void step();
+
+        // current operation
         const instruction *currOp = nullptr;
-        uint8_t operandClk = 0;
-        uint8_t processClk = 0;
 
         // pending interrupt request
         bool pendingIRQ = false;
@@ -84,367 +121,337 @@ namespace ricoh2A03
         // pending non-maskable interrupt
         bool pendingNMI = false;
 
-        // private buffer variables used by addressing mode and instruction functions
-        uint8_t *operandRef = nullptr;  // set to pointer to CPU internal register
-        int32_t operandAddr = -1;       // else set to address of operand
+        // halted by an XSTP opcode (only a reset gets out; interrupts are ignored)
+        bool jammed = false;
 
         uint64_t clock = 0;
+        uint64_t instructions = 0;
 
         #ifdef DEBUG
             std::ofstream CPUlogfile;   // debug
             bool CPUlog = false;        // debug
         #endif
 
-        // all addressing modes (http://www.obelisk.me.uk/6502/addressing.html) (http://archive.6502.org/datasheets/rockwell_r650x_r651x.pdf)
-        uint8_t ACCUM();   // accumulator addressing
-        uint8_t IMM();     // immediate address
-        uint8_t ABS();     // absolute addressing
-        uint8_t ZP();      // zero page addressing
-        uint8_t ZPX();     // indexed zero page addressing from regX
-        uint8_t ZPY();     // indexed zero page addressing from regY
-        uint8_t ABSX();    // indexed absolute addressing from regX (potential +1 delay)
-        uint8_t ABSY();    // indexed absolute addressing from regX (potential +1 delay)
-        uint8_t IMP();     // implied addressing
-        uint8_t REL();     // relative addressing (+1/+2 on success for branches)
-        uint8_t INDX();    // indexed indirect addressing from regX
-        uint8_t INDY();    // indexed indirect addressing from regY (potential +1 delay)
-        uint8_t IND();     // absolute indirect
-
-        // all instruction functions (http://6502.org/tutorials/6502opcodes.html) (http://www.obelisk.me.uk/6502/instructions.html)
-        // note: 56 valid opcodes + 1 filler opcode
-        uint8_t LDA();
-        uint8_t LDX();
-        uint8_t LDY();
-        uint8_t STA();
-        uint8_t STX();
-        uint8_t STY();
-        uint8_t TAX();
-        uint8_t TAY();
-        uint8_t TXA();
-        uint8_t TYA();
-        uint8_t TSX();
-        uint8_t TXS();
-        uint8_t PHA();
-        uint8_t PHP();
-        uint8_t PLA();
-        uint8_t PLP();
-        uint8_t AND();
-        uint8_t EOR();
-        uint8_t ORA();
-        uint8_t BIT();
-        uint8_t ADC();
-        uint8_t SBC();
-        uint8_t CMP();
-        uint8_t CPX();
-        uint8_t CPY();
-        uint8_t INC();
-        uint8_t INX();
-        uint8_t INY();
-        uint8_t DEC();
-        uint8_t DEX();
-        uint8_t DEY();
-        uint8_t ASL();
-        uint8_t LSR();
-        uint8_t ROL();
-        uint8_t ROR();
-        uint8_t JMP();
-        uint8_t JSR();
-        uint8_t RTS();
-        uint8_t BCC();
-        uint8_t BCS();
-        uint8_t BEQ();
-        uint8_t BMI();
-        uint8_t BNE();
-        uint8_t BPL();
-        uint8_t BVC();
-        uint8_t BVS();
-        uint8_t CLC();
-        uint8_t CLD();
-        uint8_t CLI();
-        uint8_t CLV();
-        uint8_t SEC();
-        uint8_t SED();
-        uint8_t SEI();
-        uint8_t BRK();
-        uint8_t NOP();
-        uint8_t RTI();
-        uint8_t XXX();  // filler funtion for illegal opcodes
+        // one handler per opcode, generated from its addressing mode and operation
+        template<addrMode M, instrOp O>
+        uint8_t exec();
+
+        template<addrMode M>
+        uint16_t address(uint8_t &cross);           // fetches the operand bytes; cross set to 1 if indexing crosses a page
+        template<instrOp O>
+        void load(uint8_t operand);                 // operations that only read memory
+        template<instrOp O>
+        uint8_t store();                            // operations that only write memory (returns value to write)
+        template<instrOp O>
+        uint8_t modify(uint8_t operand);            // read-modify-write operations (returns value to write back)
+        template<instrOp O>
+        void implied();
+        template<instrOp O>
+        bool taken();                               // branch condition
+
+        static constexpr bool reads(instrOp O)
+        {
+            return (O == LDA) || (O == LDX) || (O == LDY) || (O == AND) || (O == EOR) || (O == ORA) || (O == BIT) || (O == ADC) || (O == SBC) ||
+                   (O == CMP) || (O == CPX) || (O == CPY) || (O == XLAX) || (O == XLXA) || (O == XLAS) || (O == XANC) || (O == XALR) ||
+                   (O == XARR) || (O == XAXS) || (O == XXAA) || (O == XSBC) || (O == XNOP);
+        }
+        static constexpr bool writes(instrOp O)
+        {
+            return (O == STA) || (O == STX) || (O == STY) || (O == XSAX) || (O == XAHX) || (O == XSHX) || (O == XSHY) || (O == XTAS);
+        }
+
+        void setZN(uint8_t value);
+        void push(uint8_t data);
+        uint8_t pull();
+        void adc(uint8_t operand);                  // SBC is adc(operand ^ 0xFF)
+        void compare(uint8_t reg, uint8_t operand);
+        uint8_t asl(uint8_t operand);
+        uint8_t lsr(uint8_t operand);
+        uint8_t rol(uint8_t operand);
+        uint8_t ror(uint8_t operand);
+        uint8_t branch(uint16_t operandAddr, bool taken);   // extra cycles (+1 taken, +1 more on page cross)
+
+        #ifdef CPU_SWITCH_CORE
+            // alternative core: one dense switch over the opcode, each case calling its handler directly so it can be inlined
+            // (returns the whole instruction's cycle count)
+            uint8_t execute(uint8_t opcode);
+        #endif
 
         // opcode-to-instruction list (http://www.oxyron.de/html/opcodes02.html) (http://wiki.nesdev.com/w/index.php/CPU_unofficial_opcodes) (http://archive.6502.org/datasheets/rockwell_r65c00_microprocessors.pdf)
         // note: 4-letter operations beginning with 'X' are illegal/unoffical opcodes
-        // note: for illegal/unofficial opcodes, 1 additional cycle on crossing page boundary or branch taken for certain instructions are not implemented
-        inline static const instruction instructionSet[] = {
-            {&ricoh2A03::CPU::BRK, &ricoh2A03::CPU::IMP, 7, 0, "BRK"},
-            {&ricoh2A03::CPU::ORA, &ricoh2A03::CPU::INDX, 6, 1, "ORA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDX, 8, 0, "XSLO"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 3, 0, "XNOP"},
-            {&ricoh2A03::CPU::ORA, &ricoh2A03::CPU::ZP, 3, 1, "ORA"},
-            {&ricoh2A03::CPU::ASL, &ricoh2A03::CPU::ZP, 5, 0, "ASL"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 5, 0, "XSLO"},
-            {&ricoh2A03::CPU::PHP, &ricoh2A03::CPU::IMP, 3, 0, "PHP"},
-            {&ricoh2A03::CPU::ORA, &ricoh2A03::CPU::IMM, 2, 1, "ORA"},
-            {&ricoh2A03::CPU::ASL, &ricoh2A03::CPU::ACCUM, 2, 0, "ASL"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XANC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABS, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::ORA, &ricoh2A03::CPU::ABS, 4, 1, "ORA"},
-            {&ricoh2A03::CPU::ASL, &ricoh2A03::CPU::ABS, 6, 0, "ASL"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABS, 6, 0, "XSLO"},
-
-            {&ricoh2A03::CPU::BPL, &ricoh2A03::CPU::REL, 2, 0, "BPL"},
-            {&ricoh2A03::CPU::ORA, &ricoh2A03::CPU::INDY, 5, 1, "ORA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDY, 8, 0, "XSLO"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::ORA, &ricoh2A03::CPU::ZPX, 4, 1, "ORA"},
-            {&ricoh2A03::CPU::ASL, &ricoh2A03::CPU::ZPX, 6, 0, "ASL"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 6, 0, "XSLO"},
-            {&ricoh2A03::CPU::CLC, &ricoh2A03::CPU::IMP, 2, 0, "CLC"},
-            {&ricoh2A03::CPU::ORA, &ricoh2A03::CPU::ABSY, 4, 1, "ORA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 7, 0, "XSLO"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::ORA, &ricoh2A03::CPU::ABSX, 4, 1, "ORA"},
-            {&ricoh2A03::CPU::ASL, &ricoh2A03::CPU::ABSX, 7, 0, "ASL"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 7, 0, "XSLO"},
-
-            {&ricoh2A03::CPU::JSR, &ricoh2A03::CPU::ABS, 6, 0, "JSR"},
-            {&ricoh2A03::CPU::AND, &ricoh2A03::CPU::INDX, 6, 1, "AND"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDX, 8, 0, "XRLA"},
-            {&ricoh2A03::CPU::BIT, &ricoh2A03::CPU::ZP, 3, 0, "BIT"},
-            {&ricoh2A03::CPU::AND, &ricoh2A03::CPU::ZP, 3, 1, "AND"},
-            {&ricoh2A03::CPU::ROL, &ricoh2A03::CPU::ZP, 5, 0, "ROL"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 5, 0, "XRLA"},
-            {&ricoh2A03::CPU::PLP, &ricoh2A03::CPU::IMP, 4, 0, "PLP"},
-            {&ricoh2A03::CPU::AND, &ricoh2A03::CPU::IMM, 2, 1, "AND"},
-            {&ricoh2A03::CPU::ROL, &ricoh2A03::CPU::ACCUM, 2, 0, "ROL"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XANC"},
-            {&ricoh2A03::CPU::BIT, &ricoh2A03::CPU::ABS, 4, 0, "BIT"},
-            {&ricoh2A03::CPU::AND, &ricoh2A03::CPU::ABS, 4, 1, "AND"},
-            {&ricoh2A03::CPU::ROL, &ricoh2A03::CPU::ABS, 6, 0, "ROL"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABS, 6, 0, "XRLA"},
-
-            {&ricoh2A03::CPU::BMI, &ricoh2A03::CPU::REL, 2, 0, "BMI"},
-            {&ricoh2A03::CPU::AND, &ricoh2A03::CPU::INDY, 5, 1, "AND"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDY, 8, 0, "XRLA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::AND, &ricoh2A03::CPU::ZPX, 4, 1, "AND"},
-            {&ricoh2A03::CPU::ROL, &ricoh2A03::CPU::ZPX, 6, 0, "ROL"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 6, 0, "XRLA"},
-            {&ricoh2A03::CPU::SEC, &ricoh2A03::CPU::IMP, 2, 0, "SEC"},
-            {&ricoh2A03::CPU::AND, &ricoh2A03::CPU::ABSY, 4, 1, "AND"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 7, 0, "XRLA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::AND, &ricoh2A03::CPU::ABSX, 4, 1, "AND"},
-            {&ricoh2A03::CPU::ROL, &ricoh2A03::CPU::ABSX, 7, 0, "ROL"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 7, 0, "XRLA"},
-
-            {&ricoh2A03::CPU::RTI, &ricoh2A03::CPU::IMP, 6, 0, "RTI"},
-            {&ricoh2A03::CPU::EOR, &ricoh2A03::CPU::INDX, 6, 1, "EOR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDX, 8, 0, "XSRE"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 3, 0, "XNOP"},
-            {&ricoh2A03::CPU::EOR, &ricoh2A03::CPU::ZP, 3, 1, "EOR"},
-            {&ricoh2A03::CPU::LSR, &ricoh2A03::CPU::ZP, 5, 0, "LSR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 4, 0, "XSRE"},
-            {&ricoh2A03::CPU::PHA, &ricoh2A03::CPU::IMP, 3, 0, "PHA"},
-            {&ricoh2A03::CPU::EOR, &ricoh2A03::CPU::IMM, 2, 1, "EOR"},
-            {&ricoh2A03::CPU::LSR, &ricoh2A03::CPU::ACCUM, 2, 0, "LSR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XALR"},
-            {&ricoh2A03::CPU::JMP, &ricoh2A03::CPU::ABS, 3, 0, "JMP"},
-            {&ricoh2A03::CPU::EOR, &ricoh2A03::CPU::ABS, 4, 1, "EOR"},
-            {&ricoh2A03::CPU::LSR, &ricoh2A03::CPU::ABS, 6, 0, "LSR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABS, 6, 0, "XSRE"},
-
-            {&ricoh2A03::CPU::BVC, &ricoh2A03::CPU::REL, 2, 0, "BVC"},
-            {&ricoh2A03::CPU::EOR, &ricoh2A03::CPU::INDY, 5, 1, "EOR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDY, 8, 0, "XSRE"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::EOR, &ricoh2A03::CPU::ZPX, 4, 1, "EOR"},
-            {&ricoh2A03::CPU::LSR, &ricoh2A03::CPU::ZPX, 6, 0, "LSR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 6, 0, "XSRE"},
-            {&ricoh2A03::CPU::CLI, &ricoh2A03::CPU::IMP, 2, 0, "CLI"},
-            {&ricoh2A03::CPU::EOR, &ricoh2A03::CPU::ABSY, 4, 1, "EOR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 7, 0, "XSRE"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::EOR, &ricoh2A03::CPU::ABSX, 4, 1, "EOR"},
-            {&ricoh2A03::CPU::LSR, &ricoh2A03::CPU::ABSX, 7, 0, "LSR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 7, 0, "XSRE"},
-
-            {&ricoh2A03::CPU::RTS, &ricoh2A03::CPU::IMP, 6, 0, "RTS"},
-            {&ricoh2A03::CPU::ADC, &ricoh2A03::CPU::INDX, 6, 1, "ADC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDX, 8, 0, "XRRA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 3, 0, "XNOP"},
-            {&ricoh2A03::CPU::ADC, &ricoh2A03::CPU::ZP, 3, 1, "ADC"},
-            {&ricoh2A03::CPU::ROR, &ricoh2A03::CPU::ZP, 5, 0, "ROR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 5, 0, "XRRA"},
-            {&ricoh2A03::CPU::PLA, &ricoh2A03::CPU::IMP, 4, 0, "PLA"},
-            {&ricoh2A03::CPU::ADC, &ricoh2A03::CPU::IMM, 2, 1, "ADC"},
-            {&ricoh2A03::CPU::ROR, &ricoh2A03::CPU::ACCUM, 2, 0, "ROR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XARR"},
-            {&ricoh2A03::CPU::JMP, &ricoh2A03::CPU::IND, 5, 0, "JMP"},
-            {&ricoh2A03::CPU::ADC, &ricoh2A03::CPU::ABS, 4, 1, "ADC"},
-            {&ricoh2A03::CPU::ROR, &ricoh2A03::CPU::ABS, 6, 0, "ROR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABS, 6, 0, "XRRA"},
-
-            {&ricoh2A03::CPU::BVS, &ricoh2A03::CPU::REL, 2, 0, "BVS"},
-            {&ricoh2A03::CPU::ADC, &ricoh2A03::CPU::INDY, 5, 1, "ADC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDY, 8, 0, "XRRA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::ADC, &ricoh2A03::CPU::ZPX, 4, 1, "ADC"},
-            {&ricoh2A03::CPU::ROR, &ricoh2A03::CPU::ZPX, 6, 0, "ROR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 6, 0, "XRRA"},
-            {&ricoh2A03::CPU::SEI, &ricoh2A03::CPU::IMP, 2, 0, "SEI"},
-            {&ricoh2A03::CPU::ADC, &ricoh2A03::CPU::ABSY, 4, 1, "ADC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 7, 0, "XRRA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::ADC, &ricoh2A03::CPU::ABSX, 4, 1, "ADC"},
-            {&ricoh2A03::CPU::ROR, &ricoh2A03::CPU::ABSX, 7, 0, "ROR"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 7, 0, "XRRA"},
-
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::STA, &ricoh2A03::CPU::INDX, 6, 0, "STA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDX, 6, 0, "XSAX"},
-            {&ricoh2A03::CPU::STY, &ricoh2A03::CPU::ZP, 3, 0, "STY"},
-            {&ricoh2A03::CPU::STA, &ricoh2A03::CPU::ZP, 3, 0, "STA"},
-            {&ricoh2A03::CPU::STX, &ricoh2A03::CPU::ZP, 3, 0, "STX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 3, 0, "XSAX"},
-            {&ricoh2A03::CPU::DEY, &ricoh2A03::CPU::IMP, 2, 0, "DEY"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::TXA, &ricoh2A03::CPU::IMP, 2, 0, "TXA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XXAA"},
-            {&ricoh2A03::CPU::STY, &ricoh2A03::CPU::ABS, 4, 0, "STY"},
-            {&ricoh2A03::CPU::STA, &ricoh2A03::CPU::ABS, 4, 0, "STA"},
-            {&ricoh2A03::CPU::STX, &ricoh2A03::CPU::ABS, 4, 0, "STX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABS, 4, 0, "XSAX"},
-
-            {&ricoh2A03::CPU::BCC, &ricoh2A03::CPU::REL, 2, 0, "BCC"},
-            {&ricoh2A03::CPU::STA, &ricoh2A03::CPU::INDY, 6, 0, "STA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDY, 6, 0, "XAHX"},
-            {&ricoh2A03::CPU::STY, &ricoh2A03::CPU::ZPX, 4, 0, "STY"},
-            {&ricoh2A03::CPU::STA, &ricoh2A03::CPU::ZPX, 4, 0, "STA"},
-            {&ricoh2A03::CPU::STX, &ricoh2A03::CPU::ZPY, 4, 0, "STX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPY, 4, 0, "XSAX"},
-            {&ricoh2A03::CPU::TYA, &ricoh2A03::CPU::IMP, 2, 0, "TYA"},
-            {&ricoh2A03::CPU::STA, &ricoh2A03::CPU::ABSY, 5, 0, "STA"},
-            {&ricoh2A03::CPU::TXS, &ricoh2A03::CPU::IMP, 2, 0, "TXS"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 5, 0, "XTAS"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 5, 0, "XSHY"},
-            {&ricoh2A03::CPU::STA, &ricoh2A03::CPU::ABSX, 5, 0, "STA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 5, 0, "XSHX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 5, 0, "XAHX"},
-
-            {&ricoh2A03::CPU::LDY, &ricoh2A03::CPU::IMM, 2, 1, "LDY"},
-            {&ricoh2A03::CPU::LDA, &ricoh2A03::CPU::INDX, 6, 1, "LDA"},
-            {&ricoh2A03::CPU::LDX, &ricoh2A03::CPU::IMM, 2, 1, "LDX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDX, 6, 0, "XLAX"},
-            {&ricoh2A03::CPU::LDY, &ricoh2A03::CPU::ZP, 3, 1, "LDY"},
-            {&ricoh2A03::CPU::LDA, &ricoh2A03::CPU::ZP, 3, 1, "LDA"},
-            {&ricoh2A03::CPU::LDX, &ricoh2A03::CPU::ZP, 3, 1, "LDX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 3, 0, "XLAX"},
-            {&ricoh2A03::CPU::TAY, &ricoh2A03::CPU::IMP, 2, 0, "TAY"},
-            {&ricoh2A03::CPU::LDA, &ricoh2A03::CPU::IMM, 2, 1, "LDA"},
-            {&ricoh2A03::CPU::TAX, &ricoh2A03::CPU::IMP, 2, 0, "TAX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XLAX"},
-            {&ricoh2A03::CPU::LDY, &ricoh2A03::CPU::ABS, 4, 1, "LDY"},
-            {&ricoh2A03::CPU::LDA, &ricoh2A03::CPU::ABS, 4, 1, "LDA"},
-            {&ricoh2A03::CPU::LDX, &ricoh2A03::CPU::ABS, 4, 1, "LDX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABS, 4, 0, "XLAX"},
-
-            {&ricoh2A03::CPU::BCS, &ricoh2A03::CPU::REL, 2, 0, "BCS"},
-            {&ricoh2A03::CPU::LDA, &ricoh2A03::CPU::INDY, 5, 1, "LDA"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDY, 5, 0, "XLAX"},
-            {&ricoh2A03::CPU::LDY, &ricoh2A03::CPU::ZPX, 4, 1, "LDY"},
-            {&ricoh2A03::CPU::LDA, &ricoh2A03::CPU::ZPX, 4, 1, "LDA"},
-            {&ricoh2A03::CPU::LDX, &ricoh2A03::CPU::ZPY, 4, 1, "LDX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPY, 4, 0, "XLAX"},
-            {&ricoh2A03::CPU::CLV, &ricoh2A03::CPU::IMP, 2, 0, "CLV"},
-            {&ricoh2A03::CPU::LDA, &ricoh2A03::CPU::ABSY, 4, 1, "LDA"},
-            {&ricoh2A03::CPU::TSX, &ricoh2A03::CPU::IMP, 2, 0, "TSX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 4, 0, "XLAS"},
-            {&ricoh2A03::CPU::LDY, &ricoh2A03::CPU::ABSX, 4, 1, "LDY"},
-            {&ricoh2A03::CPU::LDA, &ricoh2A03::CPU::ABSX, 4, 1, "LDA"},
-            {&ricoh2A03::CPU::LDX, &ricoh2A03::CPU::ABSY, 4, 1, "LDX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 4, 0, "XLAX"},
-
-            {&ricoh2A03::CPU::CPY, &ricoh2A03::CPU::IMM, 2, 0, "CPY"},
-            {&ricoh2A03::CPU::CMP, &ricoh2A03::CPU::INDX, 6, 1, "CMP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDX, 8, 0, "XDCP"},
-            {&ricoh2A03::CPU::CPY, &ricoh2A03::CPU::ZP, 3, 0, "CPY"},
-            {&ricoh2A03::CPU::CMP, &ricoh2A03::CPU::ZP, 3, 1, "CMP"},
-            {&ricoh2A03::CPU::DEC, &ricoh2A03::CPU::ZP, 5, 0, "DEC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 5, 0, "XDCP"},
-            {&ricoh2A03::CPU::INY, &ricoh2A03::CPU::IMP, 2, 0, "INY"},
-            {&ricoh2A03::CPU::CMP, &ricoh2A03::CPU::IMM, 2, 1, "CMP"},
-            {&ricoh2A03::CPU::DEX, &ricoh2A03::CPU::IMP, 2, 0, "DEX"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XAXS"},
-            {&ricoh2A03::CPU::CPY, &ricoh2A03::CPU::ABS, 4, 0, "CPY"},
-            {&ricoh2A03::CPU::CMP, &ricoh2A03::CPU::ABS, 4, 1, "CMP"},
-            {&ricoh2A03::CPU::DEC, &ricoh2A03::CPU::ABS, 6, 0, "DEC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABS, 6, 0, "XDCP"},
-
-            {&ricoh2A03::CPU::BNE, &ricoh2A03::CPU::REL, 2, 0, "BNE"},
-            {&ricoh2A03::CPU::CMP, &ricoh2A03::CPU::INDY, 5, 1, "CMP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDY, 8, 0, "XDCP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::CMP, &ricoh2A03::CPU::ZPX, 4, 1, "CMP"},
-            {&ricoh2A03::CPU::DEC, &ricoh2A03::CPU::ZPX, 6, 0, "DEC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 6, 0, "XDCP"},
-            {&ricoh2A03::CPU::CLD, &ricoh2A03::CPU::IMP, 2, 0, "CLD"},
-            {&ricoh2A03::CPU::CMP, &ricoh2A03::CPU::ABSY, 4, 1, "CMP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 7, 0, "XDCP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::CMP, &ricoh2A03::CPU::ABSX, 4, 1, "CMP"},
-            {&ricoh2A03::CPU::DEC, &ricoh2A03::CPU::ABSX, 7, 0, "DEC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 7, 0, "XDCP"},
-
-            {&ricoh2A03::CPU::CPX, &ricoh2A03::CPU::IMM, 2, 0, "CPX"},
-            {&ricoh2A03::CPU::SBC, &ricoh2A03::CPU::INDX, 6, 1, "SBC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDX, 8, 0, "XISC"},
-            {&ricoh2A03::CPU::CPX, &ricoh2A03::CPU::ZP, 3, 0, "CPX"},
-            {&ricoh2A03::CPU::SBC, &ricoh2A03::CPU::ZP, 3, 1, "SBC"},
-            {&ricoh2A03::CPU::INC, &ricoh2A03::CPU::ZP, 5, 0, "INC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZP, 5, 0, "XISC"},
-            {&ricoh2A03::CPU::INX, &ricoh2A03::CPU::IMP, 2, 0, "INX"},
-            {&ricoh2A03::CPU::SBC, &ricoh2A03::CPU::IMM, 2, 1, "SBC"},
-            {&ricoh2A03::CPU::NOP, &ricoh2A03::CPU::IMP, 2, 0, "NOP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMM, 2, 0, "XSBC"},
-            {&ricoh2A03::CPU::CPX, &ricoh2A03::CPU::ABS, 4, 0, "CPX"},
-            {&ricoh2A03::CPU::SBC, &ricoh2A03::CPU::ABS, 4, 1, "SBC"},
-            {&ricoh2A03::CPU::INC, &ricoh2A03::CPU::ABS, 6, 0, "INC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABS, 6, 0, "XISC"},
-
-            {&ricoh2A03::CPU::BEQ, &ricoh2A03::CPU::REL, 2, 0, "BEQ"},
-            {&ricoh2A03::CPU::SBC, &ricoh2A03::CPU::INDY, 5, 1, "SBC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XSTP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::INDY, 8, 0, "XISC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::SBC, &ricoh2A03::CPU::ZPX, 4, 1, "SBC"},
-            {&ricoh2A03::CPU::INC, &ricoh2A03::CPU::ZPX, 6, 0, "INC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ZPX, 6, 0, "XISC"},
-            {&ricoh2A03::CPU::SED, &ricoh2A03::CPU::IMP, 2, 0, "SED"},
-            {&ricoh2A03::CPU::SBC, &ricoh2A03::CPU::ABSY, 4, 1, "SBC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::IMP, 2, 0, "XNOP"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSY, 7, 0, "XISC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 4, 0, "XNOP"},
-            {&ricoh2A03::CPU::SBC, &ricoh2A03::CPU::ABSX, 4, 1, "SBC"},
-            {&ricoh2A03::CPU::INC, &ricoh2A03::CPU::ABSX, 7, 0, "INC"},
-            {&ricoh2A03::CPU::XXX, &ricoh2A03::CPU::ABSX, 7, 0, "XISC"}
+        // note: "cycles" excludes the page crossing cycle of reads through ABSX, ABSY and INDY, which the handlers add
+        inline static constexpr instruction instructionSet[] = {
+            {&CPU::exec<IMP, BRK>, 7, "BRK"},
+            {&CPU::exec<INDX, ORA>, 6, "ORA"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDX, XSLO>, 8, "XSLO"},
+            {&CPU::exec<ZP, XNOP>, 3, "XNOP"},
+            {&CPU::exec<ZP, ORA>, 3, "ORA"},
+            {&CPU::exec<ZP, ASL>, 5, "ASL"},
+            {&CPU::exec<ZP, XSLO>, 5, "XSLO"},
+            {&CPU::exec<IMP, PHP>, 3, "PHP"},
+            {&CPU::exec<IMM, ORA>, 2, "ORA"},
+            {&CPU::exec<ACCUM, ASL>, 2, "ASL"},
+            {&CPU::exec<IMM, XANC>, 2, "XANC"},
+            {&CPU::exec<ABS, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ABS, ORA>, 4, "ORA"},
+            {&CPU::exec<ABS, ASL>, 6, "ASL"},
+            {&CPU::exec<ABS, XSLO>, 6, "XSLO"},
+
+            {&CPU::exec<REL, BPL>, 2, "BPL"},
+            {&CPU::exec<INDY, ORA>, 5, "ORA"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDY, XSLO>, 8, "XSLO"},
+            {&CPU::exec<ZPX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ZPX, ORA>, 4, "ORA"},
+            {&CPU::exec<ZPX, ASL>, 6, "ASL"},
+            {&CPU::exec<ZPX, XSLO>, 6, "XSLO"},
+            {&CPU::exec<IMP, CLC>, 2, "CLC"},
+            {&CPU::exec<ABSY, ORA>, 4, "ORA"},
+            {&CPU::exec<IMP, XNOP>, 2, "XNOP"},
+            {&CPU::exec<ABSY, XSLO>, 7, "XSLO"},
+            {&CPU::exec<ABSX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ABSX, ORA>, 4, "ORA"},
+            {&CPU::exec<ABSX, ASL>, 7, "ASL"},
+            {&CPU::exec<ABSX, XSLO>, 7, "XSLO"},
+
+            {&CPU::exec<ABS, JSR>, 6, "JSR"},
+            {&CPU::exec<INDX, AND>, 6, "AND"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDX, XRLA>, 8, "XRLA"},
+            {&CPU::exec<ZP, BIT>, 3, "BIT"},
+            {&CPU::exec<ZP, AND>, 3, "AND"},
+            {&CPU::exec<ZP, ROL>, 5, "ROL"},
+            {&CPU::exec<ZP, XRLA>, 5, "XRLA"},
+            {&CPU::exec<IMP, PLP>, 4, "PLP"},
+            {&CPU::exec<IMM, AND>, 2, "AND"},
+            {&CPU::exec<ACCUM, ROL>, 2, "ROL"},
+            {&CPU::exec<IMM, XANC>, 2, "XANC"},
+            {&CPU::exec<ABS, BIT>, 4, "BIT"},
+            {&CPU::exec<ABS, AND>, 4, "AND"},
+            {&CPU::exec<ABS, ROL>, 6, "ROL"},
+            {&CPU::exec<ABS, XRLA>, 6, "XRLA"},
+
+            {&CPU::exec<REL, BMI>, 2, "BMI"},
+            {&CPU::exec<INDY, AND>, 5, "AND"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDY, XRLA>, 8, "XRLA"},
+            {&CPU::exec<ZPX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ZPX, AND>, 4, "AND"},
+            {&CPU::exec<ZPX, ROL>, 6, "ROL"},
+            {&CPU::exec<ZPX, XRLA>, 6, "XRLA"},
+            {&CPU::exec<IMP, SEC>, 2, "SEC"},
+            {&CPU::exec<ABSY, AND>, 4, "AND"},
+            {&CPU::exec<IMP, XNOP>, 2, "XNOP"},
+            {&CPU::exec<ABSY, XRLA>, 7, "XRLA"},
+            {&CPU::exec<ABSX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ABSX, AND>, 4, "AND"},
+            {&CPU::exec<ABSX, ROL>, 7, "ROL"},
+            {&CPU::exec<ABSX, XRLA>, 7, "XRLA"},
+
+            {&CPU::exec<IMP, RTI>, 6, "RTI"},
+            {&CPU::exec<INDX, EOR>, 6, "EOR"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDX, XSRE>, 8, "XSRE"},
+            {&CPU::exec<ZP, XNOP>, 3, "XNOP"},
+            {&CPU::exec<ZP, EOR>, 3, "EOR"},
+            {&CPU::exec<ZP, LSR>, 5, "LSR"},
+            {&CPU::exec<ZP, XSRE>, 5, "XSRE"},
+            {&CPU::exec<IMP, PHA>, 3, "PHA"},
+            {&CPU::exec<IMM, EOR>, 2, "EOR"},
+            {&CPU::exec<ACCUM, LSR>, 2, "LSR"},
+            {&CPU::exec<IMM, XALR>, 2, "XALR"},
+            {&CPU::exec<ABS, JMP>, 3, "JMP"},
+            {&CPU::exec<ABS, EOR>, 4, "EOR"},
+            {&CPU::exec<ABS, LSR>, 6, "LSR"},
+            {&CPU::exec<ABS, XSRE>, 6, "XSRE"},
+
+            {&CPU::exec<REL, BVC>, 2, "BVC"},
+            {&CPU::exec<INDY, EOR>, 5, "EOR"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDY, XSRE>, 8, "XSRE"},
+            {&CPU::exec<ZPX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ZPX, EOR>, 4, "EOR"},
+            {&CPU::exec<ZPX, LSR>, 6, "LSR"},
+            {&CPU::exec<ZPX, XSRE>, 6, "XSRE"},
+            {&CPU::exec<IMP, CLI>, 2, "CLI"},
+            {&CPU::exec<ABSY, EOR>, 4, "EOR"},
+            {&CPU::exec<IMP, XNOP>, 2, "XNOP"},
+            {&CPU::exec<ABSY, XSRE>, 7, "XSRE"},
+            {&CPU::exec<ABSX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ABSX, EOR>, 4, "EOR"},
+            {&CPU::exec<ABSX, LSR>, 7, "LSR"},
+            {&CPU::exec<ABSX, XSRE>, 7, "XSRE"},
+
+            {&CPU::exec<IMP, RTS>, 6, "RTS"},
+            {&CPU::exec<INDX, ADC>, 6, "ADC"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDX, XRRA>, 8, "XRRA"},
+            {&CPU::exec<ZP, XNOP>, 3, "XNOP"},
+            {&CPU::exec<ZP, ADC>, 3, "ADC"},
+            {&CPU::exec<ZP, ROR>, 5, "ROR"},
+            {&CPU::exec<ZP, XRRA>, 5, "XRRA"},
+            {&CPU::exec<IMP, PLA>, 4, "PLA"},
+            {&CPU::exec<IMM, ADC>, 2, "ADC"},
+            {&CPU::exec<ACCUM, ROR>, 2, "ROR"},
+            {&CPU::exec<IMM, XARR>, 2, "XARR"},
+            {&CPU::exec<IND, JMP>, 5, "JMP"},
+            {&CPU::exec<ABS, ADC>, 4, "ADC"},
+            {&CPU::exec<ABS, ROR>, 6, "ROR"},
+            {&CPU::exec<ABS, XRRA>, 6, "XRRA"},
+
+            {&CPU::exec<REL, BVS>, 2, "BVS"},
+            {&CPU::exec<INDY, ADC>, 5, "ADC"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDY, XRRA>, 8, "XRRA"},
+            {&CPU::exec<ZPX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ZPX, ADC>, 4, "ADC"},
+            {&CPU::exec<ZPX, ROR>, 6, "ROR"},
+            {&CPU::exec<ZPX, XRRA>, 6, "XRRA"},
+            {&CPU::exec<IMP, SEI>, 2, "SEI"},
+            {&CPU::exec<ABSY, ADC>, 4, "ADC"},
+            {&CPU::exec<IMP, XNOP>, 2, "XNOP"},
+            {&CPU::exec<ABSY, XRRA>, 7, "XRRA"},
+            {&CPU::exec<ABSX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ABSX, ADC>, 4, "ADC"},
+            {&CPU::exec<ABSX, ROR>, 7, "ROR"},
+            {&CPU::exec<ABSX, XRRA>, 7, "XRRA"},
+
+            {&CPU::exec<IMM, XNOP>, 2, "XNOP"},
+            {&CPU::exec<INDX, STA>, 6, "STA"},
+            {&CPU::exec<IMM, XNOP>, 2, "XNOP"},
+            {&CPU::exec<INDX, XSAX>, 6, "XSAX"},
+            {&CPU::exec<ZP, STY>, 3, "STY"},
+            {&CPU::exec<ZP, STA>, 3, "STA"},
+            {&CPU::exec<ZP, STX>, 3, "STX"},
+            {&CPU::exec<ZP, XSAX>, 3, "XSAX"},
+            {&CPU::exec<IMP, DEY>, 2, "DEY"},
+            {&CPU::exec<IMM, XNOP>, 2, "XNOP"},
+            {&CPU::exec<IMP, TXA>, 2, "TXA"},
+            {&CPU::exec<IMM, XXAA>, 2, "XXAA"},
+            {&CPU::exec<ABS, STY>, 4, "STY"},
+            {&CPU::exec<ABS, STA>, 4, "STA"},
+            {&CPU::exec<ABS, STX>, 4, "STX"},
+            {&CPU::exec<ABS, XSAX>, 4, "XSAX"},
+
+            {&CPU::exec<REL, BCC>, 2, "BCC"},
+            {&CPU::exec<INDY, STA>, 6, "STA"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDY, XAHX>, 6, "XAHX"},
+            {&CPU::exec<ZPX, STY>, 4, "STY"},
+            {&CPU::exec<ZPX, STA>, 4, "STA"},
+            {&CPU::exec<ZPY, STX>, 4, "STX"},
+            {&CPU::exec<ZPY, XSAX>, 4, "XSAX"},
+            {&CPU::exec<IMP, TYA>, 2, "TYA"},
+            {&CPU::exec<ABSY, STA>, 5, "STA"},
+            {&CPU::exec<IMP, TXS>, 2, "TXS"},
+            {&CPU::exec<ABSY, XTAS>, 5, "XTAS"},
+            {&CPU::exec<ABSX, XSHY>, 5, "XSHY"},
+            {&CPU::exec<ABSX, STA>, 5, "STA"},
+            {&CPU::exec<ABSY, XSHX>, 5, "XSHX"},
+            {&CPU::exec<ABSY, XAHX>, 5, "XAHX"},
+
+            {&CPU::exec<IMM, LDY>, 2, "LDY"},
+            {&CPU::exec<INDX, LDA>, 6, "LDA"},
+            {&CPU::exec<IMM, LDX>, 2, "LDX"},
+            {&CPU::exec<INDX, XLAX>, 6, "XLAX"},
+            {&CPU::exec<ZP, LDY>, 3, "LDY"},
+            {&CPU::exec<ZP, LDA>, 3, "LDA"},
+            {&CPU::exec<ZP, LDX>, 3, "LDX"},
+            {&CPU::exec<ZP, XLAX>, 3, "XLAX"},
+            {&CPU::exec<IMP, TAY>, 2, "TAY"},
+            {&CPU::exec<IMM, LDA>, 2, "LDA"},
+            {&CPU::exec<IMP, TAX>, 2, "TAX"},
+            {&CPU::exec<IMM, XLXA>, 2, "XLXA"},
+            {&CPU::exec<ABS, LDY>, 4, "LDY"},
+            {&CPU::exec<ABS, LDA>, 4, "LDA"},
+            {&CPU::exec<ABS, LDX>, 4, "LDX"},
+            {&CPU::exec<ABS, XLAX>, 4, "XLAX"},
+
+            {&CPU::exec<REL, BCS>, 2, "BCS"},
+            {&CPU::exec<INDY, LDA>, 5, "LDA"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDY, XLAX>, 5, "XLAX"},
+            {&CPU::exec<ZPX, LDY>, 4, "LDY"},
+            {&CPU::exec<ZPX, LDA>, 4, "LDA"},
+            {&CPU::exec<ZPY, LDX>, 4, "LDX"},
+            {&CPU::exec<ZPY, XLAX>, 4, "XLAX"},
+            {&CPU::exec<IMP, CLV>, 2, "CLV"},
+            {&CPU::exec<ABSY, LDA>, 4, "LDA"},
+            {&CPU::exec<IMP, TSX>, 2, "TSX"},
+            {&CPU::exec<ABSY, XLAS>, 4, "XLAS"},
+            {&CPU::exec<ABSX, LDY>, 4, "LDY"},
+            {&CPU::exec<ABSX, LDA>, 4, "LDA"},
+            {&CPU::exec<ABSY, LDX>, 4, "LDX"},
+            {&CPU::exec<ABSY, XLAX>, 4, "XLAX"},
+
+            {&CPU::exec<IMM, CPY>, 2, "CPY"},
+            {&CPU::exec<INDX, CMP>, 6, "CMP"},
+            {&CPU::exec<IMM, XNOP>, 2, "XNOP"},
+            {&CPU::exec<INDX, XDCP>, 8, "XDCP"},
+            {&CPU::exec<ZP, CPY>, 3, "CPY"},
+            {&CPU::exec<ZP, CMP>, 3, "CMP"},
+            {&CPU::exec<ZP, DEC>, 5, "DEC"},
+            {&CPU::exec<ZP, XDCP>, 5, "XDCP"},
+            {&CPU::exec<IMP, INY>, 2, "INY"},
+            {&CPU::exec<IMM, CMP>, 2, "CMP"},
+            {&CPU::exec<IMP, DEX>, 2, "DEX"},
+            {&CPU::exec<IMM, XAXS>, 2, "XAXS"},
+            {&CPU::exec<ABS, CPY>, 4, "CPY"},
+            {&CPU::exec<ABS, CMP>, 4, "CMP"},
+            {&CPU::exec<ABS, DEC>, 6, "DEC"},
+            {&CPU::exec<ABS, XDCP>, 6, "XDCP"},
+
+            {&CPU::exec<REL, BNE>, 2, "BNE"},
+            {&CPU::exec<INDY, CMP>, 5, "CMP"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDY, XDCP>, 8, "XDCP"},
+            {&CPU::exec<ZPX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ZPX, CMP>, 4, "CMP"},
+            {&CPU::exec<ZPX, DEC>, 6, "DEC"},
+            {&CPU::exec<ZPX, XDCP>, 6, "XDCP"},
+            {&CPU::exec<IMP, CLD>, 2, "CLD"},
+            {&CPU::exec<ABSY, CMP>, 4, "CMP"},
+            {&CPU::exec<IMP, XNOP>, 2, "XNOP"},
+            {&CPU::exec<ABSY, XDCP>, 7, "XDCP"},
+            {&CPU::exec<ABSX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ABSX, CMP>, 4, "CMP"},
+            {&CPU::exec<ABSX, DEC>, 7, "DEC"},
+            {&CPU::exec<ABSX, XDCP>, 7, "XDCP"},
+
+            {&CPU::exec<IMM, CPX>, 2, "CPX"},
+            {&CPU::exec<INDX, SBC>, 6, "SBC"},
+            {&CPU::exec<IMM, XNOP>, 2, "XNOP"},
+            {&CPU::exec<INDX, XISC>, 8, "XISC"},
+            {&CPU::exec<ZP, CPX>, 3, "CPX"},
+            {&CPU::exec<ZP, SBC>, 3, "SBC"},
+            {&CPU::exec<ZP, INC>, 5, "INC"},
+            {&CPU::exec<ZP, XISC>, 5, "XISC"},
+            {&CPU::exec<IMP, INX>, 2, "INX"},
+            {&CPU::exec<IMM, SBC>, 2, "SBC"},
+            {&CPU::exec<IMP, NOP>, 2, "NOP"},
+            {&CPU::exec<IMM, XSBC>, 2, "XSBC"},
+            {&CPU::exec<ABS, CPX>, 4, "CPX"},
+            {&CPU::exec<ABS, SBC>, 4, "SBC"},
+            {&CPU::exec<ABS, INC>, 6, "INC"},
+            {&CPU::exec<ABS, XISC>, 6, "XISC"},
+
+            {&CPU::exec<REL, BEQ>, 2, "BEQ"},
+            {&CPU::exec<INDY, SBC>, 5, "SBC"},
+            {&CPU::exec<IMP, XSTP>, 2, "XSTP"},
+            {&CPU::exec<INDY, XISC>, 8, "XISC"},
+            {&CPU::exec<ZPX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ZPX, SBC>, 4, "SBC"},
+            {&CPU::exec<ZPX, INC>, 6, "INC"},
+            {&CPU::exec<ZPX, XISC>, 6, "XISC"},
+            {&CPU::exec<IMP, SED>, 2, "SED"},
+            {&CPU::exec<ABSY, SBC>, 4, "SBC"},
+            {&CPU::exec<IMP, XNOP>, 2, "XNOP"},
+            {&CPU::exec<ABSY, XISC>, 7, "XISC"},
+            {&CPU::exec<ABSX, XNOP>, 4, "XNOP"},
+            {&CPU::exec<ABSX, SBC>, 4, "SBC"},
+            {&CPU::exec<ABSX, INC>, 7, "INC"},
+            {&CPU::exec<ABSX, XISC>, 7, "XISC"}
         };
     };
 }
@@ -5,7 +5,7 @@
 
 namespace NES
 {
-    class Memory;
+    class Scheduler;
 };
 
 namespace ricoh2C02
@@ -62,6 +62,34 @@ namespace ricoh2C02
         // byte 3 is x position
     };
 
+    // work due on a dot of a scanline (PPU::tick() looks these up per dot instead of testing screenX/screenY ranges)
+    enum DOTaction
+    {
+        shiftBackground =   ((uint32_t)(1)),
+        fetchNametable =    ((uint32_t)(1) << 1),
+        reloadBackground =  ((uint32_t)(1) << 2),      // next tile into the background shifters
+        fetchAttribute =    ((uint32_t)(1) << 3),
+        fetchPatternLow =   ((uint32_t)(1) << 4),
+        fetchPatternHigh =  ((uint32_t)(1) << 5),
+        oddFrameFetch =     ((uint32_t)(1) << 6),      // (nametable byte fetched again on dot 1 of scanline 0 of odd frames)
+        clearStatus =       ((uint32_t)(1) << 7),
+        rasterizeLine =     ((uint32_t)(1) << 8),      // sprite line buffer
+        spriteFromLine =    ((uint32_t)(1) << 9),      // sprite pixel from the line buffer instead of the shifters
+        advanceShifters =   ((uint32_t)(1) << 10),     // sprite shifters catch up with the line buffer and shift once
+        clearSecondaryOAM = ((uint32_t)(1) << 11),
+        spriteEvaluation =  ((uint32_t)(1) << 12),
+        loadSprites =       ((uint32_t)(1) << 13),
+        drawPixel =         ((uint32_t)(1) << 14),
+        scrollHorizontal =  ((uint32_t)(1) << 15),     // increment v (coarse X)
+        scrollVertical =    ((uint32_t)(1) << 16),     // increment v (fine Y, then coarse Y)
+        copyHorizontal =    ((uint32_t)(1) << 17),     // t into v
+        copyVertical =      ((uint32_t)(1) << 18),
+        resetOAMaddr =      ((uint32_t)(1) << 19),
+        setVblank =         ((uint32_t)(1) << 20)
+    };
+
+    // Bus is the memory the PPU is wired to (a NES::Bus for a given mapper)
+    template<class Bus>
     class PPU
     {
         struct RGB
@@ -70,7 +98,7 @@ namespace ricoh2C02
         };
 
     public:
-        PPU(NES::Memory *m);
+        PPU(Bus *m, NES::Scheduler *s);
         ~PPU();
 
         void rst();
@@ -83,11 +111,14 @@ namespace ricoh2C02
 
         bool DMAtransfer(); // for DMA transfer
 
-        void tick();
-        bool frameComplete();
-        uint8_t* const getScreen();
+        uint8_t paletteRead(uint16_t addr) {return palette[addr & 0x001F];}     // PPU 0x3F00 - 0x3FFF
+        void paletteWrite(uint16_t addr, uint8_t data);
 
-        bool triggerNMI();
+        void tick();        // raises NES::nmi at start of vblank and NES::frameEnd after the last visible pixel
+        void catchUp();     // run the dots owed up to the scheduler's current time (before anything observes PPU state)
+        void catchUpForWrite(); // same, before anything alters PPU state (a scanline rendered ahead is redone dot by dot)
+        uint8_t* const getScreen();         // converted to RGB24 on each call
+        uint8_t* const getScreenIndices();  // 6-bit palette colour per pixel, as rendered
 
         #ifdef DEBUG
             uint8_t* const getChrROM();
@@ -96,13 +127,46 @@ namespace ricoh2C02
         #endif
 
     private:
-        NES::Memory *mem;
+        Bus *mem;
+        NES::Scheduler *scheduler;  // for triggering NMI on CPU for vblank and signaling frame end
+
+        // lazy synchronization: the PPU only runs when something can observe it
+        uint64_t nextDotTime = 0;   // timestamp of the next dot to run
+        uint8_t dotInCycle = 0;     // 0 to 2 for the dots on phases 1, 3 and 5 of a CPU cycle
+        void scheduleSync();        // schedule NES::ppuSync for the next dot that can raise an event by itself
+        void renderScanline();      // dots 1-256 of a visible scanline at once (catchUp() fast path)
+        void backgroundPixels(uint8_t *colorAddr, uint8_t dots, bool enabled);  // next dots (up to 8) of background from the shifters, shifting them on
+        bool vblankIdle();          // nothing a dot does on scanlines 240-260 can be observed (see tick())
+        void skipVblank(uint64_t now);  // run the owed dots up to the vblank flag at (241, 1) or the pre-render scanline at once (catchUp() fast path)
+
+        // a scanline rendered ahead of the dots owed so far (CPU polling $2002 mid-line); screenX keeps counting the dots actually owed
+        struct LineState
+        {
+            uint8_t bgPalette1shifter, bgPalette0shifter;
+            uint32_t bgPatternShifter;
+            bool bgPalette1Latch, bgPalette0Latch;
+            uint8_t bgNextTileID, bgNextTileAttr;
+            uint16_t bgNextPattern;
+            uint16_t vramAddrCurr;
+            uint8_t OAMsecondary[8 * 4];
+            uint8_t nxtSprToRender;
+            bool nxtRenderSprite0;
+            uint8_t status;
+            uint16_t PPUCTRLpost30000;
+        };
+        bool renderedAhead = false;
+        LineState lineStart;            // state at dot 1 of the scanline rendered ahead
+        uint8_t aheadStatus = 0x00;     // PPUSTATUS once the scanline is done (its flags show up on their dots)
+        uint16_t sprite0HitDot = 0;     // dot of the first sprite 0 hit in the last scanline rendered at once (0 if none)
+        void redoScanline();            // drop the scanline rendered ahead and tick its owed dots one by one
 
-        uint8_t *screenBuffer;  // screen following SDL_PIXELFORMAT_RGB24; 256 x 240
-        bool frameDone = false;
+        // palette RAM (PPU 0x3F00 - 0x3F1F), with each mirrored pair written together so reads need no fixup
+        uint8_t palette[32] = {0};          // raw bytes as written
+        uint8_t paletteColor[32] = {0};     // same, masked to the 6-bit colours the pixel path uses
 
-        // for triggering NMI on CPU for vblank
-        bool NMI = false;
+        uint8_t *screenIndices; // screen as 6-bit palette colours (grayscale applied); 256 x 240
+        uint8_t *screenBuffer;  // screen following SDL_PIXELFORMAT_RGB24; 256 x 240 (filled from screenIndices by getScreen())
+        uint32_t paletteRGBX[64] = {0};     // paletteRGB padded to 4 bytes per colour for the conversion
 
         // PPU registers and helper variables
         uint8_t registers[9] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};  // see Ricoh2C02.cpp for details
@@ -124,13 +188,12 @@ namespace ricoh2C02
         uint8_t fineX = 0x00;               // (x) horizontal sprite-level scrolling (3 bits with values 0-7)
         bool writeToggle = false;           // (w) 2-byte write for PPUSCROLL and APPUADDR
         uint8_t bgPalette1shifter = 0x00, bgPalette0shifter = 0x00;
-        uint16_t bgMSBshifter = 0x0000, bgLSBshifter = 0x0000;
+        uint32_t bgPatternShifter = 0x00000000;    // 2-bit pixels of the current and next tile, leftmost in bits 31-30 (see NES::Mapper::chrTile())
         bool bgPalette1Latch = false,       
              bgPalette0Latch = false;
         uint8_t bgNextTileID = 0x00,
-                bgNextTileAttr = 0x00,
-                bgNextMSB = 0x00,
-                bgNextLSB = 0x00;
+                bgNextTileAttr = 0x00;
+        uint16_t bgNextPattern = 0x0000;
         /*
         // registers v and t breakdown (see VRAMmask enums)
             // for v and t, note bits 12-14 are not used in reading from nametable and are ignored when doing so
@@ -145,8 +208,7 @@ namespace ricoh2C02
         // internal sprite registers and OAM
         uint8_t *OAMprimary;    // 64 entries of 4 bytes each
         uint8_t *OAMsecondary;  // 8 entries of 4 bytes each (literally a buffer for next scanline sprites to load into shifters after screenX = 256)
-        uint8_t sprLSBshifter[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-        uint8_t sprMSBshifter[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+        uint16_t sprPatternShifter[8] = {0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000};     // 2-bit pixels, leftmost in bits 15-14 (already flipped)
         uint8_t sprAttrLatch[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
         uint8_t sprPosX[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
@@ -156,12 +218,32 @@ namespace ricoh2C02
         bool nxtRenderSprite0 = false;      // buffered value for below as we check this the scanline before
         bool renderSprite0 = false;         // to check for sprite 0 in secondary OAM
 
+        // sprite pixels of the scanline, drawn once at dot 1 from the loaded shifters in reverse order so lower sprites win
+        // (indexed by the dots the shifters would have shifted, so sprites switched off mid-line are held back the same way)
+        uint8_t sprLineColor[264] = {0};    // palette address, 0 where transparent (a sprite at X 255 ends on 262)
+        uint8_t sprLineBehind[264] = {0};   // 0xFF where the sprite is behind the background
+        uint8_t sprLineZero[264] = {0};     // 0xFF where the pixel is from the first sprite in secondary OAM
+        uint16_t sprDot = 0;                // dots shifted since dot 1 (the shifters themselves catch up at dot 257)
+        void rasterizeSprites();            // fills the line buffer above and restarts sprDot
+        void advanceSprites();              // moves sprPosX[] and sprPatternShifter[] on by sprDot dots
+
         // helper variables to calculate sprite address in CHR ROM when preloading shifters (literally just for cycles 257-320)
         uint8_t currSpriteinOAM2 = 0x00;
         uint16_t patTableAddr = 0x0000;
         uint16_t tileID = 0x00;
         uint8_t tileRow = 0x00;
 
+        // helpers shared by tick() and renderScanline()
+        void incrementHorizontal();     // coarse X of v, wrapping into the next horizontal nametable
+        void incrementVertical();       // fine Y then coarse Y of v, wrapping into the next vertical nametable
+        void evaluateSprites();         // fills secondary OAM with the sprites on the next scanline and sets the overflow flag
+
+        // sprites in range of each line evaluateSprites() looks at (Y + 1 for scanlines 0 - 239, 0 for the pre-render line), one bit per sprite number
+        // kept up to date by OAMDATA writes (OAM DMA included), so evaluation does not have to compare all 64 Y positions per scanline
+        uint64_t lineSprites[241] = {0};
+        uint8_t lineSpritesHeight = 0;                      // sprite height lineSprites[] holds (0 until first built)
+        void indexSprite(uint8_t n, bool inRange);          // set or clear sprite n on the lines its Y position covers
+
         /*
         // Sprite representation (http://wiki.nesdev.com/w/index.php/PPU_OAM)
             // byte 0: Y position of top of sprite;
@@ -0,0 +1,78 @@
+#ifndef _SCHEDULER
+#define _SCHEDULER
+
+#include <cstdint>
+
+namespace NES
+{
+    enum event
+    {
+        nmi,            // PPU vblank NMI
+        frameIrq,       // APU frame counter IRQ
+        mapperIrq,      // cartridge IRQ (MMC3 scanline counter)
+        oamDma,         // $4014 write (CPU halted for the transfer)
+        dmcFetch,       // DMC sample fetch (CPU stalled)
+        cpuHalt,        // CPU still halted by DMA or DMC; look again next CPU cycle
+        ppuSync,        // PPU has to catch up (it may raise an event by itself)
+        apuSync,        // APU has to catch up (frame IRQ or DMC fetch due)
+        frameEnd,       // PPU finished the visible part of the frame
+        eventCount
+    };
+
+    // keeps the next deadline of every event so the main loop only has to compare one timestamp per CPU cycle
+    // timestamps count master clock phases: CPU cycle k runs at 6k, after the PPU dots at 6k-5, 6k-3 and 6k and the APU ticks at 6k-4 and 6k
+    class Scheduler
+    {
+    public:
+        Scheduler()
+        {
+            for (int i = 0; i < eventCount; i++)
+                deadline[i] = never;
+        }
+        ~Scheduler(){};
+
+        static constexpr uint64_t never = UINT64_MAX;
+
+        uint64_t now = 0;               // current phase (set by the main loop before ticking each component, and by the PPU while catching up)
+        uint64_t nextDeadline = never;  // earliest pending deadline
+
+        void schedule(event e, uint64_t at)
+        {
+            if (at < deadline[e])
+                deadline[e] = at;
+            if (at < nextDeadline)
+                nextDeadline = at;
+        }
+
+        // signals raised during a phase are seen from the next phase on (CPU ticking in the same phase misses them)
+        void raise(event e) {schedule(e, now + 1);}
+
+        // true (and clears the event) if its deadline has been reached
+        bool take(event e)
+        {
+            if (deadline[e] > now)
+                return false;
+            deadline[e] = never;
+            return true;
+        }
+
+        // CPU cycle that the current timestamp leads up to (counts through DMA and DMC stalls, like M2)
+        uint64_t cpuCycle() {return (now + 5) / 6;}
+
+        // recompute nextDeadline after taking events
+        void update()
+        {
+            nextDeadline = never;
+            for (int i = 0; i < eventCount; i++)
+            {
+                if (deadline[i] < nextDeadline)
+                    nextDeadline = deadline[i];
+            }
+        }
+
+    private:
+        uint64_t deadline[eventCount];
+    };
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef _SINK
+#define _SINK
+
+#include <cstdint>
+
+// output interfaces for the emulation core
+// (lets the frame loop and APU run without knowing whether SDL or a headless runner is on the other end)
+
+namespace NES
+{
+    class VideoSink
+    {
+    public:
+        VideoSink(){};
+        virtual ~VideoSink(){};
+
+        virtual void displayScreen(uint8_t *screen) = 0;    // called once per frame with the 256 x 240 RGB24 screen (or palette indices; see below)
+        virtual bool wantsRGB() {return true;}              // false to be handed the 6-bit palette colour per pixel instead (skips the RGB conversion)
+    };
+
+    class AudioSink
+    {
+    public:
+        AudioSink(){};
+        virtual ~AudioSink(){};
+
+        virtual void audioAddSamples(const uint8_t *samples, uint32_t count) = 0;   // unsigned 8-bit mono samples (about a frame's worth per call)
+        virtual int audioSampleRate() = 0;                  // used by APU to pace sample generation
+    };
+}
+
+#endif
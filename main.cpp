@@ -1,11 +1,7 @@
 #include <cstdint>
 #include <iostream>
 #include <string>
-#include "include/Mapper.hpp"
-#include "include/Memory.hpp"
-#include "include/Ricoh2A03.hpp"
-#include "include/Ricoh2C02.hpp"
-#include "include/APU.hpp"
+#include "include/Console.hpp"
 #include "include/IO.hpp"
 
 #ifdef GTEST
@@ -40,15 +36,14 @@ int main(int argc, char **argv)
         }
         else
             ROMfile = std::string(argv[1]);
-        NES::Memory *memory = new NES::NESmemory();
-        ricoh2A03::CPU cpu(memory);
-        ricoh2C02::PPU ppu(memory);
-        NES::IO io(memory);
-        ricoh2A03::APU apu(memory, &io);
-        memory->connect(&cpu, &ppu, &apu);
-        memory->initCartridge(ROMfile);
-        cpu.rst();
-        ppu.rst();
+        NES::IO io;
+        NES::Console console(&io, &io);
+        if (!console.initCartridge(ROMfile))
+        {
+            std::cout << "unable to load cartridge " << ROMfile << std::endl << "exiting" << std::endl;
+            return 1;
+        }
+        console.rst();
 
         const float frameMS = 1000.0f / FPS;
 
@@ -58,53 +53,21 @@ int main(int argc, char **argv)
         bool quit = false;
         bool pause = false;
         bool log = false;
-        uint8_t clkMod6 = 0;
         while (!quit)
         {
             io.audioPause(pause);
             if (!pause)
             {
                 Uint64 begin = SDL_GetPerformanceCounter();
-                do
-                {
-                    if (clkMod6 & 0x01)
-                        ppu.tick();
-                    if ((clkMod6 == 2) || (clkMod6 == 5))
-                    {
-                        apu.tick();
-                    }
-                    if (clkMod6 == 5)
-                    {
-                        if (apu.DMCReaderDelay() == 0x00)
-                        {
-                            if (memory->DMAactive())
-                                memory->handleDMA();
-                            cpu.tick(!(memory->DMAactive()));
-                            memory->toggleCpuCycle();
-                        }
-                    }
-                    if (ppu.triggerNMI())
-                        cpu.nmi();
-                    if ((memory->mapperIrqReq()) || (apu.irqReq()))
-                    {
-                        cpu.irq();
-                        memory->mapperIrqReset();
-                        apu.irqReset();
-                    }
-                    memory->finalizeDMAreq();
-                    clkMod6++;
-                    if (clkMod6 >= 6)
-                        clkMod6 = 0;
-                } while ((!ppu.frameComplete()) || ((clkMod6 & 0x01) == 0x00));
+                console.runFrame();     // also hands the finished frame to io.displayScreen()
                 // float elapsedProcess = (((float)(SDL_GetPerformanceCounter() - begin) * 1000.0f) / SDL_GetPerformanceFrequency());
                 // processingTime += elapsedProcess;
-                io.displayScreen(ppu.getScreen());
                 // elapsedProcess = (((float)(SDL_GetPerformanceCounter() - begin) * 1000.0f) / SDL_GetPerformanceFrequency()) - elapsedProcess;
                 // renderingTime += elapsedProcess;
                 #ifdef DEBUG
-                    io.displayChrROM(ppu.getChrROM());
-                    io.displayOAM(ppu.getOAM());
-                    io.displayNT(ppu.getNT());
+                    io.displayChrROM(console.getChrROM());
+                    io.displayOAM(console.getOAM());
+                    io.displayNT(console.getNT());
                 #endif
                 float elapsed = (((float)(SDL_GetPerformanceCounter() - begin) * 1000.0f) / SDL_GetPerformanceFrequency());
                 if (elapsed < frameMS)
@@ -115,15 +78,16 @@ int main(int argc, char **argv)
                 SDL_Delay(frameMS);
             }
             io.updateInputs(&quit, &pause, &log);
+            console.controllerWrite(0, io.controllerRead(0));
+            console.controllerWrite(1, io.controllerRead(1));
             #ifdef DEBUG
-                cpu.enableLog(log);
+                console.enableLog(log);
             #endif
         }
         // no point in multithreading as processing takes significantly more time than rendering
         // std::cout << "processing time: " << processingTime << std::endl;
         // std::cout << "rendering time: " << renderingTime << std::endl;
         io.audioPause(true);
-        delete memory;
         return 0;
     #endif
 }
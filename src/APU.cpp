@@ -1,8 +1,72 @@
 #include "../include/APU.hpp"
 #include "../include/Memory.hpp"
+#include "../include/Scheduler.hpp"
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+
+// the APU ticks on phases 2 and 5 of each CPU cycle (see NESsystem::runFrame()), so tick n (from 0) is at timestamp 3n + 2 or 3n + 3
+static uint64_t tickTimestamp(uint64_t tick) {return (3 * tick) + 2 + (tick & 1);}
+static uint64_t ticksUntil(uint64_t timestamp) {return ((timestamp + 4) / 6) + (timestamp / 6);}    // ticks at or before timestamp
+
+// adds delta times one phase of the band-limited step kernel (APU_BLIP_TAPS coefficients) to the buffer (see APU::blipBuffer)
+typedef void (*addStepFunc)(int32_t *buffer, const int16_t *kernel, int16_t delta);
+
+static void addStepScalar(int32_t *buffer, const int16_t *kernel, int16_t delta)
+{
+    for (int k = 0; k < APU_BLIP_TAPS; k++)
+        buffer[k] += (int32_t)(kernel[k]) * delta;
+}
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+// 8 and 16 coefficients at a time, widening the 16x16 bit products from their low and high halves; same result as addStepScalar()
+__attribute__((target("sse2")))
+static void addStepSSE2(int32_t *buffer, const int16_t *kernel, int16_t delta)
+{
+    const __m128i d = _mm_set1_epi16(delta);
+    for (int k = 0; k < APU_BLIP_TAPS; k += 8)
+    {
+        __m128i c = _mm_loadu_si128((const __m128i*)(kernel + k));
+        __m128i low = _mm_mullo_epi16(c, d);
+        __m128i high = _mm_mulhi_epi16(c, d);
+        _mm_storeu_si128((__m128i*)(buffer + k), _mm_add_epi32(_mm_loadu_si128((const __m128i*)(buffer + k)), _mm_unpacklo_epi16(low, high)));
+        _mm_storeu_si128((__m128i*)(buffer + k + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i*)(buffer + k + 4)), _mm_unpackhi_epi16(low, high)));
+    }
+}
+
+__attribute__((target("avx2")))
+static void addStepAVX2(int32_t *buffer, const int16_t *kernel, int16_t delta)
+{
+    const __m256i d = _mm256_set1_epi16(delta);
+    for (int k = 0; k < APU_BLIP_TAPS; k += 16)
+    {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(kernel + k));
+        __m256i low = _mm256_mullo_epi16(c, d);
+        __m256i high = _mm256_mulhi_epi16(c, d);
+        __m256i first = _mm256_unpacklo_epi16(low, high);       // products 0-3 and 8-11 (unpacking stays within 128-bit halves)
+        __m256i second = _mm256_unpackhi_epi16(low, high);      // products 4-7 and 12-15
+        _mm256_storeu_si256((__m256i*)(buffer + k), _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(buffer + k)), _mm256_permute2x128_si256(first, second, 0x20)));
+        _mm256_storeu_si256((__m256i*)(buffer + k + 8), _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)(buffer + k + 8)), _mm256_permute2x128_si256(first, second, 0x31)));
+    }
+}
+
+static addStepFunc pickAddStep()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return addStepAVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return addStepSSE2;
+    return addStepScalar;
+}
+#else
+static addStepFunc pickAddStep() {return addStepScalar;}
+#endif
+
+static const addStepFunc addStep = pickAddStep();
 
 uint8_t ricoh2A03::APU::cpuRead(uint16_t addr)
 {
@@ -38,6 +102,7 @@ bool ricoh2A03::APU::cpuWrite(uint16_t addr, uint8_t data)
 {
     if ((addr & 0xFFE0) == 0x4000)
     {
+        outputChanged = true;
         uint8_t reg = addr & 0x001F;
         switch (reg)
         {
@@ -159,6 +224,8 @@ bool ricoh2A03::APU::cpuWrite(uint16_t addr, uint8_t data)
                 }
                 else if ((reg & 0x03) == 1)
                     DMCChannel.counterOutput = (data & 0x7F);
+                if ((reg & 0x03) == 0)
+                    scheduleSync();     // next sample byte may be taken sooner
                 return true;
                 break;
             case 21:
@@ -179,11 +246,13 @@ bool ricoh2A03::APU::cpuWrite(uint16_t addr, uint8_t data)
                     DMCReaderFetch();
                 }
                 DMCChannel.interruptFlag = false;
+                scheduleSync();
                 return true;
             case 23:                // not completely accurate, but close enough
                 frameCounterReg = data;
                 dividerTick = 14915;
                 dividerCnt = (data & 0x80)? 0 : 4;
+                scheduleSync();
                 return true;
                 break;
             default:
@@ -198,10 +267,6 @@ bool ricoh2A03::APU::cpuWrite(uint16_t addr, uint8_t data)
 // function runs at 3579545.334 Hz
 void ricoh2A03::APU::tick()
 {
-    samplesToGenerateOffset += samplesPerTick;
-    int samplesToGenerate = (int)(floor(samplesToGenerateOffset));
-    samplesToGenerateOffset -= samplesToGenerate;
-    
     // target period for sweeper is calculated CONSTANTLY (condition for sweep unit muting)
     PulseChannel1.sweepChange = (PulseChannel1.getSequencePeriod() >> PulseChannel1.regs.shift());
     PulseChannel1.sweepTargetPeriod = PulseChannel1.getSequencePeriod() + ((PulseChannel1.regs.negate())? ~(PulseChannel1.sweepChange) : PulseChannel1.sweepChange);        // 1's complement
@@ -218,6 +283,7 @@ void ricoh2A03::APU::tick()
     if (dividerTick >= 14915)
     {
         dividerTick = 0;
+        outputChanged = true;   // envelopes, length counters and sweeps
         
         bool seq5step = (frameCounterReg & 0x80);
         bool halfSeqCheck = (seq5step)? ((dividerCnt == 0) || (dividerCnt == 2)) : ((dividerCnt == 1) || (dividerCnt == 3));
@@ -228,6 +294,7 @@ void ricoh2A03::APU::tick()
         {
             IRQ = true;
             IRQset = true;
+            scheduler->schedule(NES::frameIrq, tickTimestamp(clock - 1) + 1);     // raised at this tick's own time
         }
 
         if (halfSeqCheck)       // adjust note length and sweepers
@@ -389,17 +456,19 @@ void ricoh2A03::APU::tick()
             {
                 PulseChannel1.sequenceTimer = PulseChannel1.getSequencePeriod();
                 PulseChannel1.sequenceValue = ((PulseChannel1.sequenceValue & 0x01)? 0x80 : 0x00) | (PulseChannel1.sequenceValue >> 1);
+                outputChanged = true;
             }
-            else
-                PulseChannel1.sequenceTimer--;
+            else if (--PulseChannel1.sequenceTimer == 7)
+                outputChanged = true;   // sample() is muted for the last 8 counts
 
             if (PulseChannel2.sequenceTimer == 0x0000)
             {
                 PulseChannel2.sequenceTimer = PulseChannel2.getSequencePeriod();
                 PulseChannel2.sequenceValue = ((PulseChannel2.sequenceValue & 0x01)? 0x80 : 0x00) | (PulseChannel2.sequenceValue >> 1);
+                outputChanged = true;
             }
-            else
-                PulseChannel2.sequenceTimer--;
+            else if (--PulseChannel2.sequenceTimer == 7)
+                outputChanged = true;   // sample() is muted for the last 8 counts
         }
 
         // triangle sequencer
@@ -408,6 +477,7 @@ void ricoh2A03::APU::tick()
                 if (TriangleChannel.sequenceTimer == 0x0000)
                 {
                     TriangleChannel.sequenceTimer = TriangleChannel.getSequencePeriod();
+                    outputChanged = true;
                     if (TriangleChannel.sequenceHalfPeriod)
                     {
                         if (TriangleChannel.sequenceValue == 0x00)
@@ -431,8 +501,8 @@ void ricoh2A03::APU::tick()
         if (NoiseChannel.randomTimer == 0x0000)
         {
             NoiseChannel.randomTimer = NoiseChannel.randomPeriodTable[NoiseChannel.regs.noisePeriod()];
-            uint16_t NoiseChannelXorBitmask = (NoiseChannel.regs.loopNoise())? 0x0020 : 0x0002;
-            NoiseChannel.randomValue = (((NoiseChannel.randomValue & NoiseChannelXorBitmask) ^ ((NoiseChannel.randomValue & 0x0001)? NoiseChannelXorBitmask : 0x0000))? 0x4000 : 0x0000) | (NoiseChannel.randomValue >> 1);;
+            outputChanged = true;
+            NoiseChannel.shiftRandom();
         }
         else
             NoiseChannel.randomTimer--;
@@ -441,6 +511,7 @@ void ricoh2A03::APU::tick()
         if (DMCChannel.outputTimer == 0x00)
         {
             DMCChannel.outputTimer = DMCChannel.dmcPeriodTable[DMCChannel.regs.freq()];
+            outputChanged = true;
             if (!(DMCChannel.outputSilence))
             {
                 if (DMCChannel.outputBuffer & 0x01)
@@ -473,44 +544,166 @@ void ricoh2A03::APU::tick()
             DMCChannel.outputTimer--;
     }
 
-    // if there is a sample to add, do so (only at most 1 sample anyways since 3.6MHz >>> 44.1kHz)
-    for (int i = 0; i < samplesToGenerate; i++)
+    // add a band-limited step if the mixer output moved (instead of point-sampling it every ~80 ticks)
+    if (outputChanged)
     {
-        uint8_t pulse1Output = PulseChannel1.sample();
-        uint8_t pulse2Output = PulseChannel2.sample();
-        uint8_t triangleOutput = TriangleChannel.sample();
-        uint8_t noiseOutput = NoiseChannel.sample();
-        uint8_t dmcOutput = DMCChannel.sample();        // note: I did not rigorously test this; zero this out if any issues
-
-        #if USE_LOOKUP_TABLE
-            double pulseOutput = pulseTable[pulse1Output + pulse2Output];
-            double tndOutput = tndTable[(3 * triangleOutput) + (2 * noiseOutput) + dmcOutput];
-        #elif USE_LINEAR_APPROX
-            double pulseOutput = 0.00752f * (double)(pulse1Output + pulse2Output);
-            double tndOutput = (0.00851f * (double)(triangleOutput)) + (0.00494f * (double)(noiseOutput)) + (0.00335f * (double)(dmcOutput));
-        #else
-            double pulseOutput = (pulse1Output + pulse2Output)? (95.88f / ((double)(8128.0f / (pulse1Output + pulse2Output)) + 100.0f)) : 0.0f;
-            double tndOutput = (triangleOutput | noiseOutput | dmcOutput)? (159.79f / ((1.0f / (((double)(triangleOutput) / 8227.0f) + ((double)(noiseOutput) / 12241.0f) + ((double)(dmcOutput) / 22638.0f))) + 100.0f)) : 0.0f;
-        #endif
-
-        uint8_t mixerOutput = (uint8_t)(floor((pulseOutput + tndOutput) * 255.0f));
-
-        #if USE_FILTER
-            IO->audioAddSample(LowpassFilter.processSample(mixerOutput));
-        #else
-            IO->audioAddSample(mixerOutput);
-        #endif
+        outputChanged = false;
+        int32_t level = (int32_t)(mixerOutput() * (1 << blipBuffer::levelBits));
+        if (level != outputLevel)
+        {
+            BlipBuffer.addDelta(samplesToGenerateOffset + ((double)(blipClock) * samplesPerTick), (int16_t)(level - outputLevel));
+            outputLevel = level;
+        }
     }
+    if (++blipClock >= blipClockLimit)
+        generateSamples();
     
     dividerTick++;
     ++timerCount &= 0x03;
 }
 
+// run every tick up to the current timestamp, skipping over stretches where no channel steps
+void ricoh2A03::APU::catchUp()
+{
+    uint64_t target = ticksUntil(scheduler->now);
+    while (clock < target)
+    {
+        uint64_t ticks = std::min<uint64_t>(idleTicks(), target - clock);
+        if (ticks)
+        {
+            skipTicks((uint32_t)(ticks));
+            clock += ticks;
+        }
+        else
+        {
+            clock++;
+            tick();
+        }
+    }
+    scheduleSync();     // always (a sync still pending from before a register access caught the APU up will just come early)
+}
+
+// a tick has to run through tick() if the frame sequencer runs, the sample buffer fills, a register was written, or a channel
+// that can be heard steps (silent pulse and noise channels are left to skipTicks())
+uint32_t ricoh2A03::APU::idleTicks()
+{
+    if (outputChanged)
+        return 0;
+    uint32_t ticks = (dividerTick >= 14915)? 0 : (14915 - dividerTick);
+    ticks = std::min(ticks, blipClockLimit - 1 - blipClock);
+
+    // pulse timers are clocked on ticks where timerCount is 3, the others on odd ones; nth clock from now is on tick (phase + (n - 1) * rate)
+    uint32_t pulsePhase = 3 - timerCount;
+    uint32_t timerPhase = (timerCount & 0x01)? 0 : 1;
+    if (PulseChannel1.lengthCounter)
+        ticks = std::min(ticks, pulsePhase + (4 * (uint32_t)((PulseChannel1.sequenceTimer >= 8)? (PulseChannel1.sequenceTimer - 8) : PulseChannel1.sequenceTimer)));
+    if (PulseChannel2.lengthCounter)
+        ticks = std::min(ticks, pulsePhase + (4 * (uint32_t)((PulseChannel2.sequenceTimer >= 8)? (PulseChannel2.sequenceTimer - 8) : PulseChannel2.sequenceTimer)));
+    if ((TriangleChannel.linearCounter > 0) && (TriangleChannel.lengthCounter > 0))
+        ticks = std::min(ticks, timerPhase + (2 * (uint32_t)(TriangleChannel.sequenceTimer)));
+    if (NoiseChannel.lengthCounter)
+        ticks = std::min(ticks, timerPhase + (2 * (uint32_t)(NoiseChannel.randomTimer)));
+    ticks = std::min(ticks, timerPhase + (2 * (uint32_t)(DMCChannel.outputTimer)));
+    return ticks;
+}
+
+// same as running tick() that many times when none of them would make a step that idleTicks() looks for
+void ricoh2A03::APU::skipTicks(uint32_t ticks)
+{
+    uint32_t pulseClocks = (timerCount + ticks) >> 2;
+    uint32_t timerClocks = ((timerCount + ticks) >> 1) - (timerCount >> 1);
+
+    PulseChannel1.advanceTimer(pulseClocks);
+    PulseChannel2.advanceTimer(pulseClocks);
+    if ((TriangleChannel.linearCounter > 0) && (TriangleChannel.lengthCounter > 0))
+        TriangleChannel.sequenceTimer -= timerClocks;
+    NoiseChannel.advanceTimer(timerClocks);
+    DMCChannel.outputTimer -= timerClocks;
+
+    IRQset = false;
+    blipClock += ticks;
+    dividerTick += ticks;
+    timerCount = (timerCount + ticks) & 0x03;
+}
+
+// the CPU has to see a frame IRQ or DMC fetch on the cycle it happens, so have the main loop catch up the APU on the next tick
+// that may do either: the next frame sequencer step, or (with a sample byte buffered) the DMC output unit running out of bits
+void ricoh2A03::APU::scheduleSync()
+{
+    uint64_t next = clock + ((dividerTick >= 14915)? 0 : (14915 - dividerTick));
+    if (!(DMCChannel.sampleEmpty))
+    {
+        uint32_t period = (uint32_t)(DMCChannel.dmcPeriodTable[DMCChannel.regs.freq()]) + 1;
+        uint64_t dmcTick = clock + ((timerCount & 0x01)? 0 : 1) + (2 * (DMCChannel.outputTimer + ((uint32_t)(DMCChannel.outputCounter - 1) * period)));
+        next = std::min(next, dmcTick);
+    }
+    scheduler->schedule(NES::apuSync, tickTimestamp(next));
+}
+
+void ricoh2A03::APU::flushSamples()
+{
+    catchUp();
+    generateSamples();
+}
+
+void ricoh2A03::APU::generateSamples()
+{
+    double samples = samplesToGenerateOffset + ((double)(blipClock) * samplesPerTick);
+    uint32_t sampleCount = (uint32_t)(samples);
+    samplesToGenerateOffset = samples - sampleCount;
+    blipClock = 0;
+    if (sampleCount == 0)
+        return;
+    BlipBuffer.readSamples(sampleBatch, sampleCount);
+    audio->audioAddSamples(sampleBatch, sampleCount);
+}
+
+void ricoh2A03::APU::blipBuffer::addDelta(double time, int16_t delta)
+{
+    uint32_t index = (uint32_t)(time);
+    addStep(buffer + index, kernel[(int)((time - index) * phases)], delta);
+}
+
+void ricoh2A03::APU::blipBuffer::readSamples(uint8_t *out, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        integrator += buffer[i];
+        int32_t sample = integrator >> (levelBits + kernelBits);
+        out[i] = (sample > 0)? ((sample < 255)? (uint8_t)(sample) : 0xFF) : 0x00;     // steps ring slightly past the mixer's range
+    }
+    memmove(buffer, buffer + count, taps * sizeof(int32_t));
+    memset(buffer + taps, 0, count * sizeof(int32_t));
+}
+
+double ricoh2A03::APU::mixerOutput()
+{
+    uint8_t pulse1Output = PulseChannel1.sample();
+    uint8_t pulse2Output = PulseChannel2.sample();
+    uint8_t triangleOutput = TriangleChannel.sample();
+    uint8_t noiseOutput = NoiseChannel.sample();
+    uint8_t dmcOutput = DMCChannel.sample();        // note: I did not rigorously test this; zero this out if any issues
+
+    #if USE_LOOKUP_TABLE
+        double pulseOutput = pulseTable[pulse1Output + pulse2Output];
+        double tndOutput = tndTable[(3 * triangleOutput) + (2 * noiseOutput) + dmcOutput];
+    #elif USE_LINEAR_APPROX
+        double pulseOutput = 0.00752f * (double)(pulse1Output + pulse2Output);
+        double tndOutput = (0.00851f * (double)(triangleOutput)) + (0.00494f * (double)(noiseOutput)) + (0.00335f * (double)(dmcOutput));
+    #else
+        double pulseOutput = (pulse1Output + pulse2Output)? (95.88f / ((double)(8128.0f / (pulse1Output + pulse2Output)) + 100.0f)) : 0.0f;
+        double tndOutput = (triangleOutput | noiseOutput | dmcOutput)? (159.79f / ((1.0f / (((double)(triangleOutput) / 8227.0f) + ((double)(noiseOutput) / 12241.0f) + ((double)(dmcOutput) / 22638.0f))) + 100.0f)) : 0.0f;
+    #endif
+
+    return (pulseOutput + tndOutput) * 255.0f;
+}
+
 void ricoh2A03::APU::DMCReaderFetch()
 {
     if (!(DMCChannel.sampleEmpty) || !(DMCChannel.readerBytesRemaining))
         return;
     DMCChannel.readerDelay = 4;
+    scheduler->schedule(NES::dmcFetch, tickTimestamp(clock - 1));    // stalls the CPU cycle of this phase (if it hasn't run yet)
     DMCChannel.sampleBuffer = mem->cpuRead(DMCChannel.readerAddr);
     DMCChannel.sampleEmpty = false;
     if (DMCChannel.readerAddr == 0xFFFF)
@@ -54,7 +54,7 @@ NES::Cartridge::Cartridge(std::string filename)
             std::cout << "PRG ROM size: " << std::dec << (int)(16384 * nPrgROM) << " bytes" << std::endl;
 
             nChrROM = ((header.flags9 & 0xF0) == 0xF0)? ((header.nChrROM >> 2) * ((2 * (header.nChrROM & 0x03)) + 1)) : (((uint16_t)(header.flags9 & 0xF0) << 4) | header.nChrROM);
-            chrROM = new uint8_t[8192 * nChrROM];
+            chrROM = new uint8_t[8192 * ((nChrROM > 0)? nChrROM : 1)]();    // NOTE: if 0, chrROM is utilized as CHR RAM (at least 8kB, as the mappers assume)
             NESfile.read((char*)(chrROM), 8192 * nChrROM);
             std::cout << "CHR ROM size: " << std::dec << (int)(8192 * nChrROM) << " bytes" << std::endl;
         }
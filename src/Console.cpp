@@ -0,0 +1,143 @@
+#include "../include/Console.hpp"
+#include "../include/Cartridge.hpp"
+
+#include <iostream>
+
+NES::Console::Console(NES::VideoSink *v, NES::AudioSink *a) : video(v), audio(a) {}
+
+NES::Console::~Console()
+{
+    delete system;
+}
+
+bool NES::Console::initCartridge(std::string filename)
+{
+    Cartridge *c = new Cartridge(filename);
+    if (c->inesFormat == 0)
+    {
+        delete c;
+        return false;
+    }
+    delete system;
+    std::cout << "Cartridge Mapper ID: " << (int)(c->mapperID) << std::endl << "Generating ";
+    switch(c->mapperID)
+    {
+        case 1:
+            system = new NESsystem<Mapper1>(c, audio);
+            std::cout << "Mapper 1" << std::endl;
+            break;
+        case 2:
+            system = new NESsystem<Mapper2>(c, audio);
+            std::cout << "Mapper 2" << std::endl;
+            break;
+        case 3:
+            system = new NESsystem<Mapper3>(c, audio);
+            std::cout << "Mapper 3" << std::endl;
+            break;
+        case 4:
+            system = new NESsystem<Mapper4>(c, audio);
+            std::cout << "Mapper 4" << std::endl;
+            break;
+        default:
+            system = new NESsystem<Mapper0>(c, audio);
+            std::cout << "Mapper 0" << std::endl;
+            break;
+    }
+    return true;
+}
+
+void NES::Console::rst()
+{
+    if (system)
+        system->rst();
+}
+
+void NES::Console::runFrame()
+{
+    if (!system)
+        return;
+    system->runFrame();
+    if (video)
+        video->displayScreen((video->wantsRGB())? system->getScreen() : system->getScreenIndices());
+}
+
+void NES::Console::controllerWrite(uint8_t player, uint8_t data)
+{
+    if (system)
+        system->controllerWrite(player, data);
+}
+
+
+
+template<class MapperT>
+NES::NESsystem<MapperT>::NESsystem(NES::Cartridge *c, NES::AudioSink *a) : bus(new MapperT(c, &scheduler), &scheduler), cpu(&bus), ppu(&bus, &scheduler), apu(&bus, a, &scheduler)
+{
+    bus.connect(&cpu, &ppu, &apu);
+}
+
+template<class MapperT>
+void NES::NESsystem<MapperT>::rst()
+{
+    cpu.rst();
+    ppu.rst();
+    scheduler.now += 6;     // run up to the first CPU cycle (phase 5)
+}
+
+// each CPU cycle is 6 master clock phases; PPU ticks on phases 1, 3 and 5, APU on phases 2 and 5, CPU last on phase 5
+// the loop sits just before a CPU cycle and only leaves the fast path when the scheduler has something due
+// the PPU and APU are not ticked here; they catch up by themselves whenever they are observed (register and mapper accesses, DMA, end of frame, or a scheduled sync)
+template<class MapperT>
+void NES::NESsystem<MapperT>::runFrame()
+{
+    for (;;)
+    {
+        if (scheduler.now >= scheduler.nextDeadline)
+        {
+            if (handleEvents())
+                break;
+        }
+        else
+            cpu.tick(true);
+        scheduler.now += 6;
+    }
+    apu.flushSamples();
+}
+
+template<class MapperT>
+bool NES::NESsystem<MapperT>::handleEvents()
+{
+    scheduler.take(NES::ppuSync);
+    ppu.catchUp();          // may raise NMI or frame end for this cycle
+    if (scheduler.take(NES::frameEnd))
+        return true;    // anything else due stays pending for this CPU cycle on the next frame
+    if (scheduler.take(NES::nmi))
+        cpu.nmi();
+    if (scheduler.take(NES::apuSync))
+        apu.catchUp();      // may raise a frame IRQ or DMC fetch for this cycle
+    bool apuIrq = scheduler.take(NES::frameIrq);
+    bool cartIrq = scheduler.take(NES::mapperIrq);
+    if (apuIrq || cartIrq)
+    {
+        cpu.irq();
+        bus.mapperIrqReset();
+        apu.irqReset();
+    }
+    if (scheduler.take(NES::oamDma))
+        bus.finalizeDMAreq();
+    if (scheduler.take(NES::dmcFetch))
+        dmcStall = apu.DMCReaderDelay();
+    scheduler.take(NES::cpuHalt);
+
+    if (dmcStall)
+        dmcStall--;
+    else
+    {
+        if (bus.DMAactive())
+            bus.handleDMA();
+        cpu.tick(!(bus.DMAactive()));
+    }
+    if (dmcStall || bus.DMAactive())
+        scheduler.schedule(NES::cpuHalt, scheduler.now + 6);
+    scheduler.update();
+    return false;
+}
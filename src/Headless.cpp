@@ -0,0 +1,85 @@
+#include "../include/Headless.hpp"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <iostream>
+
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+
+NES::HeadlessIO::HeadlessIO()
+{
+}
+
+NES::HeadlessIO::~HeadlessIO()
+{
+}
+
+void NES::HeadlessIO::displayScreen(uint8_t *screen)
+{
+    uint32_t hash = FNV_OFFSET;
+    for (int i = 0; i < (256 * 240); i++)
+        hash = (hash ^ screen[i]) * FNV_PRIME;
+    lastFrameHash = hash;
+    for (int i = 0; i < 4; i++)
+        allFramesHash = (allFramesHash ^ ((hash >> (i * 8)) & 0xFF)) * FNV_PRIME;
+    frameCount++;
+}
+
+void NES::HeadlessIO::audioAddSamples(const uint8_t *samples, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+        sampleHash = (sampleHash ^ samples[i]) * FNV_PRIME;
+    sampleCount += count;
+}
+
+
+
+bool NES::InputScript::load(std::string filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cout << "unable to open input file " << filename << std::endl;
+        return false;
+    }
+    std::string line;
+    int lineNum = 0;
+    while (std::getline(file, line))
+    {
+        lineNum++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        std::istringstream fields(line);
+        Entry entry = {0, {0x00, 0x00}};
+        unsigned int p1 = 0, p2 = 0;
+        if (!(fields >> entry.frame))
+            continue;   // blank line
+        if (!(fields >> std::hex >> p1))
+        {
+            std::cout << "input file line " << lineNum << ": expected \"<frame> <player 1 hex> [<player 2 hex>]\"" << std::endl;
+            return false;
+        }
+        fields >> p2;
+        entry.data[0] = (uint8_t)(p1);
+        entry.data[1] = (uint8_t)(p2);
+        entries.push_back(entry);
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {return a.frame < b.frame;});
+    nextEntry = 0;
+    current[0] = current[1] = 0x00;
+    return true;
+}
+
+uint8_t NES::InputScript::controllerState(uint64_t frame, uint8_t player)
+{
+    // frames are expected to be queried in increasing order
+    while ((nextEntry < entries.size()) && (entries[nextEntry].frame <= frame))
+    {
+        current[0] = entries[nextEntry].data[0];
+        current[1] = entries[nextEntry].data[1];
+        nextEntry++;
+    }
+    return current[player & 0x01];
+}
@@ -1,10 +1,9 @@
 #include "../include/IO.hpp"
-#include "../include/Memory.hpp"
 #include <cstring>
 
 #include <iostream>
 
-NES::IO::IO(NES::Memory *m) : mem(m)
+NES::IO::IO()
 {
     if((SDL_Init(SDL_INIT_VIDEO|SDL_INIT_AUDIO) == -1))
     { 
@@ -103,8 +102,8 @@ void NES::IO::displayScreen(uint8_t *screen)
 
 void NES::IO::updateInputs(bool *quit, bool *pause, bool *log)
 {
-    uint8_t data0 = mem->controllerRead(0);
-    uint8_t data1 = mem->controllerRead(1);
+    uint8_t data0 = controllerState[0];
+    uint8_t data1 = controllerState[1];
     while (SDL_PollEvent(&event))
     {
         switch (event.type)
@@ -233,36 +232,35 @@ void NES::IO::updateInputs(bool *quit, bool *pause, bool *log)
                 break;
         }
     }
-    mem->controllerWrite(0, data0);
-    mem->controllerWrite(1, data1);
+    controllerState[0] = data0;
+    controllerState[1] = data1;
 }
 
-void NES::IO::audioAddSample(uint8_t sample)
+void NES::IO::audioAddSamples(const uint8_t *samples, uint32_t count)
 {
-    SDL_LockAudioDevice(audioHandler);
-    if ((soundBufferIndex != soundBufferStart) || !soundBufferLoop)
+    // note this function is never called if game loop is paused
+    uint32_t written = soundWritten.load(std::memory_order_relaxed);
+    uint32_t read = soundRead.load(std::memory_order_acquire);
+    uint32_t space = (AUDIO_LATENCY_SAMPLES * 2) - (written - read);
+    if (count > space)      // (samples that do not fit are dropped)
+        count = space;
+    uint32_t start = written & (AUDIO_RING_SAMPLES - 1);
+    uint32_t first = ((AUDIO_RING_SAMPLES - start) >= count)? count : (AUDIO_RING_SAMPLES - start);
+    memcpy(&soundBuffer[start], samples, first * sizeof(uint8_t));
+    memcpy(soundBuffer, samples + first, (count - first) * sizeof(uint8_t));
+    soundWritten.store(written + count, std::memory_order_release);
+
+    uint32_t sampleDiff = written + count - read;
+    if (audioPlaybackPaused && (sampleDiff >= AUDIO_LATENCY_SAMPLES))
     {
-        soundBuffer[soundBufferIndex++] = sample;
-        if (soundBufferIndex >= (AUDIO_LATENCY_SAMPLES * 2))
-        {
-            soundBufferIndex = 0;
-            soundBufferLoop = true;
-        }
-        // note this function is never called if game loop is paused
-        uint32_t sampleDiff = ((soundBufferLoop)? (soundBufferIndex + (AUDIO_LATENCY_SAMPLES * 2)) : soundBufferIndex)
-                            - soundBufferStart;
-        if (audioPlaybackPaused && (sampleDiff >= AUDIO_LATENCY_SAMPLES))
-        {
-            SDL_PauseAudioDevice(audioHandler, 0);
-            audioPlaybackPaused = false;
-        }
-        else if (!audioPlaybackPaused && (sampleDiff < AUDIO_FRAME_SAMPLES))
-        {
-            SDL_PauseAudioDevice(audioHandler, 1);
-            audioPlaybackPaused = true;
-        }
+        SDL_PauseAudioDevice(audioHandler, 0);
+        audioPlaybackPaused = false;
+    }
+    else if (!audioPlaybackPaused && (sampleDiff < AUDIO_FRAME_SAMPLES))
+    {
+        SDL_PauseAudioDevice(audioHandler, 1);
+        audioPlaybackPaused = true;
     }
-    SDL_UnlockAudioDevice(audioHandler);
 }
 
 void NES::IO::audioPause(bool p)
@@ -276,35 +274,19 @@ void NES::IO::audioPause(bool p)
 
 void NES::IO::audioCallback(void* userdata, uint8_t* stream, int len)
 {
-    if (soundBufferLoop)
-    {
-        uint32_t numSamples = (((AUDIO_LATENCY_SAMPLES * 2) - soundBufferStart) >= (uint32_t)(len))? (uint32_t)(len) : ((AUDIO_LATENCY_SAMPLES * 2) - soundBufferStart);
-        memcpy(stream, &soundBuffer[soundBufferStart], numSamples * sizeof(uint8_t));
-        if (numSamples < len)
-        {
-            len -= (int)(numSamples);
-            uint32_t numSamples2 = (soundBufferIndex >= (uint32_t)(len))? len : soundBufferIndex;
-            memcpy(stream + numSamples, soundBuffer, numSamples2 * sizeof(uint8_t));
-            if (numSamples2 < len)
-                memset(stream + numSamples + numSamples2, stream[(numSamples + numSamples2)? (numSamples + numSamples2 - 1) : 0], ((uint32_t)(len) - numSamples2) * sizeof(uint8_t));
-            soundBufferStart = soundBufferStart + numSamples + numSamples2;
-        }
-        else
-            soundBufferStart += numSamples;
-        if (soundBufferStart >= (AUDIO_LATENCY_SAMPLES * 2))
-        {
-            soundBufferStart -= (AUDIO_LATENCY_SAMPLES * 2);
-            soundBufferLoop = false;
-        }
-    }
-    else
-    {
-        uint32_t numSamples = ((soundBufferIndex - soundBufferStart) >= (uint32_t)(len))? (uint32_t)(len) : (soundBufferIndex - soundBufferStart);
-        memcpy(stream, &soundBuffer[soundBufferStart], numSamples * sizeof(uint8_t));
-        if (numSamples < len)
-            memset(stream + numSamples, soundBuffer[(soundBufferIndex)? (soundBufferIndex - 1) : ((AUDIO_LATENCY_SAMPLES * 2) - 1)], ((uint32_t)(len) - numSamples) * sizeof(uint8_t));
-        soundBufferStart += numSamples;
-    }
+    NES::IO *io = (NES::IO*)(userdata);
+    uint32_t read = io->soundRead.load(std::memory_order_relaxed);
+    uint32_t available = io->soundWritten.load(std::memory_order_acquire) - read;
+    uint32_t numSamples = (available >= (uint32_t)(len))? (uint32_t)(len) : available;
+    uint32_t start = read & (AUDIO_RING_SAMPLES - 1);
+    uint32_t first = ((AUDIO_RING_SAMPLES - start) >= numSamples)? numSamples : (AUDIO_RING_SAMPLES - start);
+    memcpy(stream, &io->soundBuffer[start], first * sizeof(uint8_t));
+    memcpy(stream + first, io->soundBuffer, (numSamples - first) * sizeof(uint8_t));
+    if (numSamples)
+        io->soundLast = stream[numSamples - 1];
+    if (numSamples < (uint32_t)(len))
+        memset(stream + numSamples, io->soundLast, ((uint32_t)(len) - numSamples) * sizeof(uint8_t));
+    io->soundRead.store(read + numSamples, std::memory_order_release);
 }
 
 int NES::IO::audioSampleRate()
@@ -1,11 +1,11 @@
 #include "../include/Mapper.hpp"
 #include "../include/Cartridge.hpp"
 #include "../include/Memory.hpp"
-#include "../include/Ricoh2A03.hpp"
+#include "../include/Scheduler.hpp"
 
 #include <iostream>
 
-NES::Mapper::Mapper(Cartridge *c) : mapperID(c->mapperID), cart(c)
+NES::Mapper::Mapper(Cartridge *c, NES::Scheduler *s) : mapperID(c->mapperID), cart(c), scheduler(s)
 {
     EXPROM = new uint8_t[0x5FFF - 0x4020 + 1]{0};
     SRAM = new uint8_t[0x7FFF - 0x6000 + 1]{0};
@@ -15,6 +15,13 @@ NES::Mapper::Mapper(Cartridge *c) : mapperID(c->mapperID), cart(c)
             SRAM[0x7000 + i] = cart->trainer[i];    // load trainer data to 0x7000
     }
     NAMETABLE = new uint8_t[0x2FFF - 0x2000 + 1]{0};
+    chrSize = 8192 * ((cart->nChrROM > 0)? cart->nChrROM : 1);
+    chrTiles = new uint16_t[chrSize];
+    for (uint32_t offset = 0; offset < chrSize; offset += 16)
+    {
+        for (uint32_t row = 0; row < 8; row++)
+            decodeChr(offset + row);
+    }
 }
 
 NES::Mapper::~Mapper()
@@ -23,48 +30,99 @@ NES::Mapper::~Mapper()
     delete[] EXPROM;
     delete[] SRAM;
     delete[] NAMETABLE;
+    delete[] chrTiles;
+}
+
+void NES::Mapper::mapPages(uint8_t **table, uint16_t first, uint16_t count, uint8_t *base)
+{
+    for (uint16_t i = 0; i < count; i++)
+        table[first + i] = (base)? (base + (i << 8)) : nullptr;
+}
+
+void NES::Mapper::mapEXPROM(bool readable, bool writable)
+{
+    mapPages(readPage, 0x41, 0x1F, (readable)? (EXPROM + (0x4100 - 0x4020)) : nullptr);
+    mapPages(writePage, 0x41, 0x1F, (writable)? (EXPROM + (0x4100 - 0x4020)) : nullptr);
 }
 
+void NES::Mapper::mapSRAM(bool enabled)
+{
+    mapPages(readPage, 0x60, 0x20, (enabled)? SRAM : nullptr);
+    mapPages(writePage, 0x60, 0x20, (enabled)? SRAM : nullptr);
+}
 
+void NES::Mapper::mapPrg(uint8_t slot, uint8_t count, uint8_t *base)
+{
+    for (uint8_t i = 0; i < count; i++)
+        prgSlot[slot + i] = base + (i * 0x2000);
+}
 
-NES::Mapper* NES::createMapper(std::string filename, ricoh2A03::CPU *cpu)
+void NES::Mapper::mapChr(uint8_t slot, uint8_t count, uint8_t *base)
 {
-    Cartridge *c = new Cartridge(filename);
-    Mapper *m;
-    if (c->inesFormat == 0)
-        return nullptr;
-    std::cout << "Cartridge Mapper ID: " << (int)(c->mapperID) << std::endl << "Generating ";
-    switch(c->mapperID)
+    for (uint8_t i = 0; i < count; i++)
     {
-        case 1:
-            m = new Mapper1(c);
-            std::cout << "Mapper 1" << std::endl;
-            break;
-        case 2:
-            m = new Mapper2(c);
-            std::cout << "Mapper 2" << std::endl;
-            break;
-        case 3:
-            m = new Mapper3(c);
-            std::cout << "Mapper 3" << std::endl;
-            break;
-        case 4:
-            m = new Mapper4(c, cpu);
-            std::cout << "Mapper 4" << std::endl;
-            break;
-        default:
-            m = new Mapper0(c);
-            std::cout << "Mapper 0" << std::endl;
-            break;
+        chrSlot[slot + i] = base + (i * 0x0400);
+        chrTileSlot[slot + i] = chrTiles + ((chrSlot[slot + i] - cart->chrROM) % chrSize);
+    }
+}
+
+void NES::Mapper::decodeChr(uint32_t offset)
+{
+    uint8_t *plane = cart->chrROM + (offset & ~0x0008);   // plane 0 byte of the row; plane 1 is 8 bytes after
+    uint16_t pixels = 0x0000, flipped = 0x0000;
+    for (uint8_t i = 0; i < 8; i++)     // bit i is the (7 - i)th pixel from the left
+    {
+        uint16_t pixel = ((plane[0] >> i) & 0x01) | (((plane[8] >> i) & 0x01) << 1);
+        pixels |= pixel << (2 * i);
+        flipped |= pixel << (14 - (2 * i));
     }
-    return m;
+    uint16_t *tile = chrTiles + ((((offset >> 1) & ~0x0007) | (offset & 0x0007)) << 1);
+    tile[0] = pixels;
+    tile[1] = flipped;
+}
+
+void NES::Mapper::writeChr(uint32_t offset, uint8_t data)
+{
+    offset %= chrSize;
+    cart->chrROM[offset] = data;
+    decodeChr(offset);
 }
 
+void NES::Mapper::mapPrgPages()
+{
+    for (uint8_t slot = 0; slot < 4; slot++)
+        mapPages(readPage, 0x80 + (slot * 0x20), 0x20, prgSlot[slot]);
+}
+
+void NES::Mapper::mapNametables(mirror m)
+{
+    static const uint16_t offsets[5][4] = {     // offsets into NAMETABLE for 0x2000, 0x2400, 0x2800 and 0x2C00
+        {0x0000, 0x0000, 0x0800, 0x0800},   // horizontal
+        {0x0000, 0x0400, 0x0000, 0x0400},   // vertical
+        {0x0400, 0x0400, 0x0400, 0x0400},   // singleScreenLower
+        {0x0000, 0x0000, 0x0000, 0x0000},   // singleScreenUpper
+        {0x0000, 0x0400, 0x0800, 0x0C00}    // fourScreen
+    };
+    if (m > mirror::fourScreen)
+        return;
+    for (uint8_t i = 0; i < 4; i++)
+        ntSlot[i] = NAMETABLE + offsets[m][i];
+}
+
+void NES::Mapper::mapPpuPages()
+{
+    for (uint8_t i = 0; i < 8; i++)
+        ppuPage[i] = chrSlot[i];
+    for (uint8_t i = 0; i < 8; i++)
+        ppuPage[8 + i] = ntSlot[i & 0x03];  // 0x3000 - 0x3EFF mirrors 0x2000 - 0x2EFF
+}
 
 
-NES::Mapper0::Mapper0(Cartridge *c) : Mapper(c)
+
+NES::Mapper0::Mapper0(Cartridge *c, NES::Scheduler *s) : Mapper(c, s)
 {
-    ntMirror = (cart->vertMirror)? mirror::vertical : mirror::horizontal;
+    ntMirror = (cart->VRAM4screen)? mirror::fourScreen : ((cart->vertMirror)? mirror::vertical : mirror::horizontal);
+    updateBanks();
 }
 
 NES::Mapper0::~Mapper0() {}
@@ -78,12 +136,7 @@ uint8_t NES::Mapper0::cpuRead(uint16_t addr)
     else if (addr < 0x8000)
         return SRAM[addr - 0x6000];
     else
-    {
-        if (addr < 0xC000)
-            return cart->prgROM[addr & 0x3FFF];
-        else
-            return cart->prgROM[((cart->nPrgROM - 1) * 0x4000) + (addr & 0x3FFF)];  // just set to last PRGROM bank
-    }
+        return prgSlot[(addr >> 13) & 0x03][addr & 0x1FFF];
 }
 
 bool NES::Mapper0::cpuWrite(uint16_t addr, uint8_t data)
@@ -106,20 +159,9 @@ bool NES::Mapper0::cpuWrite(uint16_t addr, uint8_t data)
 uint8_t NES::Mapper0::ppuRead(uint16_t addr)
 {
     if (addr <= 0x1FFF)
-        return cart->chrROM[addr];
+        return chrSlot[addr >> 10][addr & 0x03FF];
     else if (addr <= 0x3EFF)
-    {
-        addr &= 0x0FFF;
-        if (ntMirror == mirror::horizontal)
-        {
-            if (addr <= 0x07FF)
-                return NAMETABLE[addr & 0x03FF];
-            else
-                return NAMETABLE[addr & 0x0BFF];
-        }
-        else if (ntMirror == mirror::vertical)
-            return NAMETABLE[addr & 0x07FF];
-    }
+        return ntSlot[(addr >> 10) & 0x03][addr & 0x03FF];    // mirroring resolved in updateBanks()
     return 0x00;
 }
 
@@ -127,29 +169,36 @@ bool NES::Mapper0::ppuWrite(uint16_t addr, uint8_t data)
 {
     if ((addr <= 0x1FFF) && !(cart->nChrROM))       // CHR-RAM functionality; see "https://wiki.nesdev.com/w/index.php/Category:Mappers_with_CHR_RAM"
     {
-        cart->chrROM[addr] = data;
+        writeChr((chrSlot[addr >> 10] - cart->chrROM) + (addr & 0x03FF), data);
         return true;
     }
     else if (addr <= 0x3EFF)
     {
-        addr &= 0x0FFF;
-        if (ntMirror == mirror::horizontal)
-        {
-            if (addr <= 0x07FF)
-                NAMETABLE[addr & 0x03FF] = data;
-            else
-                NAMETABLE[addr & 0x0BFF] = data;
-            return true;
-        }
-        else if (ntMirror == mirror::vertical)
-        {
-            NAMETABLE[addr & 0x07FF] = data;
-            return true;
-        }
+        ntSlot[(addr >> 10) & 0x03][addr & 0x03FF] = data;   // mirroring resolved in updateBanks()
+        return true;
     }
     return false;
 }
 
+void NES::Mapper0::updatePages()
+{
+    if (!readPage)
+        return;
+    mapEXPROM(true, true);
+    mapSRAM(true);
+    mapPrgPages();
+    mapPpuPages();
+}
+
+void NES::Mapper0::updateBanks()
+{
+    mapPrg(0, 2, cart->prgROM);
+    mapPrg(2, 2, cart->prgROM + ((cart->nPrgROM - 1) * 0x4000));     // just set to last PRGROM bank
+    mapChr(0, 8, cart->chrROM);
+    mapNametables(ntMirror);
+    updatePages();
+}
+
 #ifdef DEBUG
     uint8_t NES::Mapper0::cpuReadDebug(uint16_t addr)
     {
@@ -164,7 +213,10 @@ bool NES::Mapper0::ppuWrite(uint16_t addr, uint8_t data)
 
 
 
-NES::Mapper1::Mapper1(Cartridge *c) : Mapper(c) {}      // ntMirror is unused for this mapper
+NES::Mapper1::Mapper1(Cartridge *c, NES::Scheduler *s) : Mapper(c, s)        // ntMirror is unused for this mapper (mirroring comes from regCtrl)
+{
+    updateBanks();
+}
 
 NES::Mapper1::~Mapper1() {}
 
@@ -176,26 +228,8 @@ uint8_t NES::Mapper1::cpuRead(uint16_t addr)
         return (regPrgBank & 0x0010)? 0x00 : EXPROM[addr - 0x4020];
     else if (addr < 0x8000)
         return (regPrgBank & 0x0010)? 0x00 : SRAM[addr - 0x6000];
-    else    // mapper specific functionality
-    {
-        switch ((regCtrl & 0x000C) >> 2)
-        {
-            case 0:
-            case 1:
-                return cart->prgROM[(((regPrgBank & 0x0E) >> 1) * 0x8000) + (addr & 0x7FFF)];
-            case 2:
-                if (addr < 0xC000)
-                    return cart->prgROM[addr & 0x3FFF];
-                else
-                    return cart->prgROM[((regPrgBank & 0x0F) * 0x4000) + (addr & 0x3FFF)];
-            case 3:
-                if (addr < 0xC000)
-                    return cart->prgROM[((regPrgBank & 0x0F) * 0x4000) + (addr & 0x3FFF)];
-                else
-                    return cart->prgROM[((cart->nPrgROM - 1) * 0x4000) + (addr & 0x3FFF)];
-        }
-        return 0x00;
-    }
+    else    // mapper specific functionality (banks resolved in updateBanks())
+        return prgSlot[(addr >> 13) & 0x03][addr & 0x1FFF];
 }
 
 bool NES::Mapper1::cpuWrite(uint16_t addr, uint8_t data)
@@ -248,6 +282,7 @@ bool NES::Mapper1::cpuWrite(uint16_t addr, uint8_t data)
                         regPrgBank = regLoad;
                         break;
                 }
+                updateBanks();
                 regLoad = 0x00;
                 loadCount = 0;
             }
@@ -258,38 +293,10 @@ bool NES::Mapper1::cpuWrite(uint16_t addr, uint8_t data)
 
 uint8_t NES::Mapper1::ppuRead(uint16_t addr)
 {
-    if (addr <= 0x0FFF)
-    {
-        if (regCtrl & 0x10)
-            return cart->chrROM[((regChrBank0 & 0x1F) * 0x1000) + addr];
-        else
-            return cart->chrROM[(((regChrBank0 & 0x1E) >> 1) * 0x2000) + addr];
-    }
-    else if (addr <= 0x1FFF)
-    {
-        if (regCtrl & 0x10)
-            return cart->chrROM[((regChrBank1 & 0x1F) * 0x1000) + (addr & 0x0FFF)];
-        else
-            return cart->chrROM[(((regChrBank0 & 0x1E) >> 1) * 0x2000) + addr];
-    }
+    if (addr <= 0x1FFF)
+        return chrSlot[addr >> 10][addr & 0x03FF];
     else if (addr <= 0x3EFF)
-    {
-        addr &= 0x0FFF;
-        switch (regCtrl & 0x03)
-        {
-            case 0:     // one-screen lower bank
-                return NAMETABLE[0x0400 + (addr & 0x03FF)];
-            case 1:     // one-screen upper bank
-                return NAMETABLE[addr & 0x03FF];
-            case 2:     // vertical
-                return NAMETABLE[addr & 0x07FF];
-            case 3:     // horizontal
-                if (addr <= 0x07FF)
-                    return NAMETABLE[addr & 0x03FF];
-                else
-                    return NAMETABLE[addr & 0x0BFF];
-        }
-    }
+        return ntSlot[(addr >> 10) & 0x03][addr & 0x03FF];    // mirroring resolved in updateBanks()
     return 0x00;
 }
 
@@ -298,44 +305,79 @@ bool NES::Mapper1::ppuWrite(uint16_t addr, uint8_t data)
     if ((addr <= 0x0FFF) && !(cart->nChrROM))       // CHR-RAM functionality; see "https://wiki.nesdev.com/w/index.php/Category:Mappers_with_CHR_RAM"
     {
         if (regCtrl & 0x10)
-            cart->chrROM[((regChrBank0 & 0x1F) * 0x1000) + addr] = data;
+            writeChr(((regChrBank0 & 0x1F) * 0x1000) + addr, data);
         else
-            cart->chrROM[addr] = data;              // note: there is only 8kB worth of CHR RAM
+            writeChr(addr, data);                   // note: there is only 8kB worth of CHR RAM
         return true;
     }
     if ((addr <= 0x1FFF) && !(cart->nChrROM))       // CHR-RAM functionality; see "https://wiki.nesdev.com/w/index.php/Category:Mappers_with_CHR_RAM"
     {
         if (regCtrl & 0x10)
-            cart->chrROM[((regChrBank1 & 0x1F) * 0x1000) + (addr & 0x0FFF)] = data;
+            writeChr(((regChrBank1 & 0x1F) * 0x1000) + (addr & 0x0FFF), data);
         else
-            cart->chrROM[addr] = data;              // note: there is only 8kB worth of CHR RAM
+            writeChr(addr, data);                   // note: there is only 8kB worth of CHR RAM
         return true;
     }
     else if (addr <= 0x3EFF)
     {
-        addr &= 0x0FFF;
-        switch (regCtrl & 0x03)
-        {
-            case 0:     // one-screen lower bank
-                NAMETABLE[0x0400 + (addr & 0x03FF)] = data;
-                return true;
-            case 1:     // one-screen upper bank
-                NAMETABLE[addr & 0x03FF] = data;
-                return true;
-            case 2:     // vertical
-                NAMETABLE[addr & 0x07FF] = data;
-                return true;
-            case 3:     // horizontal
-                if (addr <= 0x07FF)
-                    NAMETABLE[addr & 0x03FF] = data;
-                else
-                    NAMETABLE[addr & 0x0BFF] = data;
-                return true;
-        }
+        ntSlot[(addr >> 10) & 0x03][addr & 0x03FF] = data;   // mirroring resolved in updateBanks()
+        return true;
     }
     return false;
 }
 
+void NES::Mapper1::updatePages()
+{
+    if (!readPage)
+        return;
+    mapEXPROM(!(regPrgBank & 0x0010), !(regPrgBank & 0x0010));
+    mapSRAM(!(regPrgBank & 0x0010));
+    mapPrgPages();
+    mapPpuPages();
+}
+
+void NES::Mapper1::updateBanks()
+{
+    switch ((regCtrl & 0x000C) >> 2)
+    {
+        case 0:
+        case 1:
+            mapPrg(0, 4, cart->prgROM + (((regPrgBank & 0x0E) >> 1) * 0x8000));
+            break;
+        case 2:
+            mapPrg(0, 2, cart->prgROM);
+            mapPrg(2, 2, cart->prgROM + ((regPrgBank & 0x0F) * 0x4000));
+            break;
+        case 3:
+            mapPrg(0, 2, cart->prgROM + ((regPrgBank & 0x0F) * 0x4000));
+            mapPrg(2, 2, cart->prgROM + ((cart->nPrgROM - 1) * 0x4000));
+            break;
+    }
+    if (regCtrl & 0x10)
+    {
+        mapChr(0, 4, cart->chrROM + ((regChrBank0 & 0x1F) * 0x1000));
+        mapChr(4, 4, cart->chrROM + ((regChrBank1 & 0x1F) * 0x1000));
+    }
+    else
+        mapChr(0, 8, cart->chrROM + (((regChrBank0 & 0x1E) >> 1) * 0x2000));
+    switch (regCtrl & 0x03)
+    {
+        case 0:     // one-screen lower bank
+            mapNametables(mirror::singleScreenLower);
+            break;
+        case 1:     // one-screen upper bank
+            mapNametables(mirror::singleScreenUpper);
+            break;
+        case 2:
+            mapNametables(mirror::vertical);
+            break;
+        case 3:
+            mapNametables(mirror::horizontal);
+            break;
+    }
+    updatePages();
+}
+
 #ifdef DEBUG
     uint8_t NES::Mapper1::cpuReadDebug(uint16_t addr)
     {
@@ -350,9 +392,10 @@ bool NES::Mapper1::ppuWrite(uint16_t addr, uint8_t data)
 
 
 
-NES::Mapper2::Mapper2(Cartridge *c) : Mapper(c)
+NES::Mapper2::Mapper2(Cartridge *c, NES::Scheduler *s) : Mapper(c, s)
 {
-    ntMirror = (cart->vertMirror)? mirror::vertical : mirror::horizontal;
+    ntMirror = (cart->VRAM4screen)? mirror::fourScreen : ((cart->vertMirror)? mirror::vertical : mirror::horizontal);
+    updateBanks();
 }
 
 NES::Mapper2::~Mapper2() {}
@@ -365,13 +408,8 @@ uint8_t NES::Mapper2::cpuRead(uint16_t addr)
         return EXPROM[addr - 0x4020];
     else if (addr < 0x8000)
         return SRAM[addr - 0x6000];
-    else    // mapper specific functionality
-    {
-        if (addr < 0xC000)
-            return cart->prgROM[(regBankSelect * 0x4000) + (addr & 0x3FFF)];
-        else
-            return cart->prgROM[((cart->nPrgROM - 1) * 0x4000) + (addr & 0x3FFF)];
-    }
+    else    // mapper specific functionality (banks resolved in updateBanks())
+        return prgSlot[(addr >> 13) & 0x03][addr & 0x1FFF];
 }
 
 bool NES::Mapper2::cpuWrite(uint16_t addr, uint8_t data)
@@ -390,26 +428,16 @@ bool NES::Mapper2::cpuWrite(uint16_t addr, uint8_t data)
     }
     // mapper specific functionality
     regBankSelect = data & 0x0F;
+    updateBanks();
     return true;
 }
 
 uint8_t NES::Mapper2::ppuRead(uint16_t addr)
 {
     if (addr <= 0x1FFF)
-        return cart->chrROM[addr];
+        return chrSlot[addr >> 10][addr & 0x03FF];
     else if (addr <= 0x3EFF)
-    {
-        addr &= 0x0FFF;
-        if (ntMirror == mirror::horizontal)
-        {
-            if (addr <= 0x07FF)
-                return NAMETABLE[addr & 0x03FF];
-            else
-                return NAMETABLE[addr & 0x0BFF];
-        }
-        else if (ntMirror == mirror::vertical)
-            return NAMETABLE[addr & 0x07FF];
-    }
+        return ntSlot[(addr >> 10) & 0x03][addr & 0x03FF];    // mirroring resolved in updateBanks()
     return 0x00;
 }
 
@@ -417,29 +445,36 @@ bool NES::Mapper2::ppuWrite(uint16_t addr, uint8_t data)
 {
     if ((addr <= 0x1FFF) && !(cart->nChrROM))       // CHR-RAM functionality; see "https://wiki.nesdev.com/w/index.php/Category:Mappers_with_CHR_RAM"
     {
-        cart->chrROM[addr] = data;
+        writeChr((chrSlot[addr >> 10] - cart->chrROM) + (addr & 0x03FF), data);
         return true;
     }
     else if (addr <= 0x3EFF)
     {
-        addr &= 0x0FFF;
-        if (ntMirror == mirror::horizontal)
-        {
-            if (addr <= 0x07FF)
-                NAMETABLE[addr & 0x03FF] = data;
-            else
-                NAMETABLE[addr & 0x0BFF] = data;
-            return true;
-        }
-        else if (ntMirror == mirror::vertical)
-        {
-            NAMETABLE[addr & 0x07FF] = data;
-            return true;
-        }
+        ntSlot[(addr >> 10) & 0x03][addr & 0x03FF] = data;   // mirroring resolved in updateBanks()
+        return true;
     }
     return false;
 }
 
+void NES::Mapper2::updatePages()
+{
+    if (!readPage)
+        return;
+    mapEXPROM(true, true);
+    mapSRAM(true);
+    mapPrgPages();
+    mapPpuPages();
+}
+
+void NES::Mapper2::updateBanks()
+{
+    mapPrg(0, 2, cart->prgROM + (regBankSelect * 0x4000));
+    mapPrg(2, 2, cart->prgROM + ((cart->nPrgROM - 1) * 0x4000));
+    mapChr(0, 8, cart->chrROM);
+    mapNametables(ntMirror);
+    updatePages();
+}
+
 #ifdef DEBUG
     uint8_t NES::Mapper2::cpuReadDebug(uint16_t addr)
     {
@@ -454,9 +489,10 @@ bool NES::Mapper2::ppuWrite(uint16_t addr, uint8_t data)
 
 
 
-NES::Mapper3::Mapper3(Cartridge *c) : Mapper(c)
+NES::Mapper3::Mapper3(Cartridge *c, NES::Scheduler *s) : Mapper(c, s)
 {
-    ntMirror = (cart->vertMirror)? mirror::vertical : mirror::horizontal;
+    ntMirror = (cart->VRAM4screen)? mirror::fourScreen : ((cart->vertMirror)? mirror::vertical : mirror::horizontal);
+    updateBanks();
 }
 
 NES::Mapper3::~Mapper3() {}
@@ -470,12 +506,7 @@ uint8_t NES::Mapper3::cpuRead(uint16_t addr)
     else if (addr < 0x8000)
         return SRAM[addr - 0x6000];
     else
-    {
-        if (addr < 0xC000)
-            return cart->prgROM[addr & 0x3FFF];
-        else
-            return cart->prgROM[((cart->nPrgROM - 1) * 0x4000) + (addr & 0x3FFF)];  // just set to last PRGROM bank
-    }
+        return prgSlot[(addr >> 13) & 0x03][addr & 0x1FFF];
 }
 
 bool NES::Mapper3::cpuWrite(uint16_t addr, uint8_t data)
@@ -494,26 +525,16 @@ bool NES::Mapper3::cpuWrite(uint16_t addr, uint8_t data)
     }
     // mapper specific functionality
     regBankSelect = data & 0x03;
+    updateBanks();
     return true;
 }
 
 uint8_t NES::Mapper3::ppuRead(uint16_t addr)
 {
-    if (addr <= 0x1FFF)                             // mapper specific functionality
-        return cart->chrROM[(regBankSelect * 0x2000) + addr];
+    if (addr <= 0x1FFF)                             // mapper specific functionality (bank resolved in updateBanks())
+        return chrSlot[addr >> 10][addr & 0x03FF];
     else if (addr <= 0x3EFF)
-    {
-        addr &= 0x0FFF;
-        if (ntMirror == mirror::horizontal)
-        {
-            if (addr <= 0x07FF)
-                return NAMETABLE[addr & 0x03FF];
-            else
-                return NAMETABLE[addr & 0x0BFF];
-        }
-        else if (ntMirror == mirror::vertical)
-            return NAMETABLE[addr & 0x07FF];
-    }
+        return ntSlot[(addr >> 10) & 0x03][addr & 0x03FF];    // mirroring resolved in updateBanks()
     return 0x00;
 }
 
@@ -521,29 +542,36 @@ bool NES::Mapper3::ppuWrite(uint16_t addr, uint8_t data)
 {
     if ((addr <= 0x1FFF) && !(cart->nChrROM))       // CHR-RAM functionality; see "https://wiki.nesdev.com/w/index.php/Category:Mappers_with_CHR_RAM"
     {
-        cart->chrROM[addr] = data;                  // note: there is only 8kB worth of CHR RAM
+        writeChr(addr, data);                       // note: there is only 8kB worth of CHR RAM
         return true;
     }
     else if (addr <= 0x3EFF)
     {
-        addr &= 0x0FFF;
-        if (ntMirror == mirror::horizontal)
-        {
-            if (addr <= 0x07FF)
-                NAMETABLE[addr & 0x03FF] = data;
-            else
-                NAMETABLE[addr & 0x0BFF] = data;
-            return true;
-        }
-        else if (ntMirror == mirror::vertical)
-        {
-            NAMETABLE[addr & 0x07FF] = data;
-            return true;
-        }
+        ntSlot[(addr >> 10) & 0x03][addr & 0x03FF] = data;   // mirroring resolved in updateBanks()
+        return true;
     }
     return false;
 }
 
+void NES::Mapper3::updatePages()
+{
+    if (!readPage)
+        return;
+    mapEXPROM(true, true);
+    mapSRAM(true);
+    mapPrgPages();
+    mapPpuPages();
+}
+
+void NES::Mapper3::updateBanks()
+{
+    mapPrg(0, 2, cart->prgROM);
+    mapPrg(2, 2, cart->prgROM + ((cart->nPrgROM - 1) * 0x4000));     // just set to last PRGROM bank
+    mapChr(0, 8, cart->chrROM + (regBankSelect * 0x2000));
+    mapNametables(ntMirror);
+    updatePages();
+}
+
 #ifdef DEBUG
     uint8_t NES::Mapper3::cpuReadDebug(uint16_t addr)
     {
@@ -558,9 +586,11 @@ bool NES::Mapper3::ppuWrite(uint16_t addr, uint8_t data)
 
 
 
-NES::Mapper4::Mapper4(Cartridge *c, ricoh2A03::CPU *cpu) : Mapper(c), cpu(cpu)
+NES::Mapper4::Mapper4(Cartridge *c, NES::Scheduler *s) : Mapper(c, s)
 {
-    ntMirror = (cart->vertMirror)? mirror::vertical : mirror::horizontal;
+    A12watch = true;
+    ntMirror = (cart->VRAM4screen)? mirror::fourScreen : ((cart->vertMirror)? mirror::vertical : mirror::horizontal);
+    updateBanks();
 }
 
 NES::Mapper4::~Mapper4() {}
@@ -573,23 +603,8 @@ uint8_t NES::Mapper4::cpuRead(uint16_t addr)
         return EXPROM[addr - 0x4020];
     else if (addr < 0x8000)
         return SRAM[addr - 0x6000];
-    else
-    {
-        switch ((addr & 0x6000) >> 13)
-        {
-            case 0:     // 0x8000
-                return (regBankSelect & 0x40)? cart->prgROM[((cart->nPrgROM - 1) * 0x4000) + (addr & 0x1FFF)]
-                                             : cart->prgROM[((bankRegisters[6] & 0x3F) * 0x2000) + (addr & 0x1FFF)];
-            case 1:     // 0xA000
-                return cart->prgROM[((bankRegisters[7] & 0x3F) * 0x2000) + (addr & 0x1FFF)];
-            case 2:     // 0xC000
-                return (regBankSelect & 0x40)? cart->prgROM[((bankRegisters[6] & 0x3F) * 0x2000) + (addr & 0x1FFF)]
-                                             : cart->prgROM[((cart->nPrgROM - 1) * 0x4000) + (addr & 0x1FFF)];
-            case 3:     // 0xE000
-                return cart->prgROM[((cart->nPrgROM - 1) * 0x4000) + (addr & 0x3FFF)];
-        }
-        return 0x00;
-    }
+    else    // banks resolved in updateBanks()
+        return prgSlot[(addr >> 13) & 0x03][addr & 0x1FFF];
 }
 
 bool NES::Mapper4::cpuWrite(uint16_t addr, uint8_t data)
@@ -615,12 +630,19 @@ bool NES::Mapper4::cpuWrite(uint16_t addr, uint8_t data)
                     bankRegisters[regBankSelect & 0x07] = data;
                 else
                     regBankSelect = data;
+                updateBanks();
                 return true;
             case 1:     // 0xA000
                 if (addr & 0x0001)
+                {
                     regPrgRamProtect = data;
+                    updatePages();
+                }
                 else
+                {
                     regMirror = data;
+                    updateBanks();
+                }
                 return true;
             case 2:     // 0xC000
                 if (addr & 0x0001)
@@ -646,61 +668,9 @@ uint8_t NES::Mapper4::ppuRead(uint16_t addr)
 {
     updateIrqCounter(addr);
     if (addr <= 0x1FFF)
-    {
-        if (regBankSelect & 0x80)
-        {
-            switch ((addr & 0x1C00) >> 10)
-            {
-                case 0:     // 0x0000
-                    return cart->chrROM[(bankRegisters[2] * 0x0400) + (addr & 0x03FF)];
-                case 1:     // 0x0400
-                    return cart->chrROM[(bankRegisters[3] * 0x0400) + (addr & 0x03FF)];
-                case 2:     // 0x0800
-                    return cart->chrROM[(bankRegisters[4] * 0x0400) + (addr & 0x03FF)];
-                case 3:     // 0x0C00
-                    return cart->chrROM[(bankRegisters[5] * 0x0400) + (addr & 0x03FF)];
-                case 4:     // 0x1000
-                case 5:
-                    return cart->chrROM[((bankRegisters[0] & 0xFE) * 0x0400) + (addr & 0x07FF)];
-                case 6:     // 0x1800
-                case 7:
-                    return cart->chrROM[((bankRegisters[1] & 0xFE) * 0x0400) + (addr & 0x07FF)];
-            }
-        }
-        else
-        {
-            switch ((addr & 0x1C00) >> 10)
-            {
-                case 0:     // 0x0000
-                case 1:
-                    return cart->chrROM[((bankRegisters[0] & 0xFE) * 0x0400) + (addr & 0x07FF)];
-                case 2:     // 0x0800
-                case 3:
-                    return cart->chrROM[((bankRegisters[1] & 0xFE) * 0x0400) + (addr & 0x07FF)];
-                case 4:     // 0x1000
-                    return cart->chrROM[(bankRegisters[2] * 0x0400) + (addr & 0x03FF)];
-                case 5:     // 0x1400
-                    return cart->chrROM[(bankRegisters[3] * 0x0400) + (addr & 0x03FF)];
-                case 6:     // 0x1800
-                    return cart->chrROM[(bankRegisters[4] * 0x0400) + (addr & 0x03FF)];
-                case 7:     // 0x1C00
-                    return cart->chrROM[(bankRegisters[5] * 0x0400) + (addr & 0x03FF)];
-            }
-        }
-    }
+        return chrSlot[addr >> 10][addr & 0x03FF];
     else if (addr <= 0x3EFF)
-    {
-        addr &= 0x0FFF;
-        if (regMirror & 0x01)   // horizontal
-        {
-            if (addr <= 0x07FF)
-                return NAMETABLE[addr & 0x03FF];
-            else
-                return NAMETABLE[addr & 0x0BFF];
-        }
-        else                    // vertical
-            return NAMETABLE[addr & 0x07FF];
-    }
+        return ntSlot[(addr >> 10) & 0x03][addr & 0x03FF];    // mirroring resolved in updateBanks()
     return 0x00;
 }
 
@@ -709,75 +679,13 @@ bool NES::Mapper4::ppuWrite(uint16_t addr, uint8_t data)
     updateIrqCounter(addr);
     if ((addr <= 0x1FFF) && !(cart->nChrROM))       // CHR-RAM functionality; see "https://wiki.nesdev.com/w/index.php/Category:Mappers_with_CHR_RAM"
     {
-        if (regBankSelect & 0x80)
-        {
-            switch ((addr & 0x1C00) >> 10)
-            {
-                case 0:     // 0x0000
-                    cart->chrROM[(bankRegisters[2] * 0x0400) + (addr & 0x03FF)] = data;
-                    return true;
-                case 1:     // 0x0400
-                    cart->chrROM[(bankRegisters[3] * 0x0400) + (addr & 0x03FF)] = data;
-                    return true;
-                case 2:     // 0x0800
-                    cart->chrROM[(bankRegisters[4] * 0x0400) + (addr & 0x03FF)] = data;
-                    return true;
-                case 3:     // 0x0C00
-                    cart->chrROM[(bankRegisters[5] * 0x0400) + (addr & 0x03FF)] = data;
-                    return true;
-                case 4:     // 0x1000
-                case 5:
-                    cart->chrROM[((bankRegisters[0] & 0xFE) * 0x0400) + (addr & 0x07FF)] = data;
-                    return true;
-                case 6:     // 0x1800
-                case 7:
-                    cart->chrROM[((bankRegisters[1] & 0xFE) * 0x0400) + (addr & 0x07FF)] = data;
-                    return true;
-            }
-        }
-        else
-        {
-            switch ((addr & 0x1C00) >> 10)
-            {
-                case 0:     // 0x0000
-                case 1:
-                    cart->chrROM[((bankRegisters[0] & 0xFE) * 0x0400) + (addr & 0x07FF)] = data;
-                    return true;
-                case 2:     // 0x0800
-                case 3:
-                    cart->chrROM[((bankRegisters[1] & 0xFE) * 0x0400) + (addr & 0x07FF)] = data;
-                    return true;
-                case 4:     // 0x1000
-                    cart->chrROM[(bankRegisters[2] * 0x0400) + (addr & 0x03FF)] = data;
-                    return true;
-                case 5:     // 0x1400
-                    cart->chrROM[(bankRegisters[3] * 0x0400) + (addr & 0x03FF)] = data;
-                    return true;
-                case 6:     // 0x1800
-                    cart->chrROM[(bankRegisters[4] * 0x0400) + (addr & 0x03FF)] = data;
-                    return true;
-                case 7:     // 0x1C00
-                    cart->chrROM[(bankRegisters[5] * 0x0400) + (addr & 0x03FF)] = data;
-                    return true;
-            }
-        }
+        writeChr((chrSlot[addr >> 10] - cart->chrROM) + (addr & 0x03FF), data);
+        return true;
     }
     else if (addr <= 0x3EFF)
     {
-        addr &= 0x0FFF;
-        if (regMirror & 0x01)   // horizontal
-        {
-            if (addr <= 0x07FF)
-                NAMETABLE[addr & 0x03FF] = data;
-            else
-                NAMETABLE[addr & 0x0BFF] = data;
-            return true;
-        }
-        else                    // vertical
-        {
-            NAMETABLE[addr & 0x07FF] = data;
-            return true;
-        }
+        ntSlot[(addr >> 10) & 0x03][addr & 0x03FF] = data;   // mirroring resolved in updateBanks()
+        return true;
     }
     return false;
 }
@@ -791,14 +699,14 @@ void NES::Mapper4::updateIrqCounter(uint16_t addr)
         if (!A12down)
         {
             A12down = true;
-            A12FirstDown = cpu->getClock();
+            A12FirstDown = scheduler->cpuCycle();
         }
     }
     else
     {
         if (A12down)
         {
-            uint64_t currClock = cpu->getClock();
+            uint64_t currClock = scheduler->cpuCycle();
             if ((currClock < A12FirstDown) || ((currClock - A12FirstDown) >= (uint64_t)(3)))
             {
                 if (!irqCounter)
@@ -806,13 +714,46 @@ void NES::Mapper4::updateIrqCounter(uint16_t addr)
                 else
                     irqCounter--;
                 if ((!irqCounter) && irqEnable)
+                {
                     IRQ = true;
+                    scheduler->raise(NES::mapperIrq);
+                }
             }
             A12down = false;
         }
     }
 }
 
+void NES::Mapper4::updatePages()
+{
+    if (!readPage)
+        return;
+    mapEXPROM(regPrgRamProtect & 0x80, (regPrgRamProtect & 0x80) && (regPrgRamProtect & 0x60));
+    mapSRAM(true);
+    mapPrgPages();
+    mapPpuPages();
+}
+
+void NES::Mapper4::updateBanks()
+{
+    uint8_t *secondLast = cart->prgROM + ((cart->nPrgROM - 1) * 0x4000);    // second to last 8kB bank
+    uint8_t *bank6 = cart->prgROM + ((bankRegisters[6] & 0x3F) * 0x2000);
+    mapPrg(0, 1, (regBankSelect & 0x40)? secondLast : bank6);
+    mapPrg(1, 1, cart->prgROM + ((bankRegisters[7] & 0x3F) * 0x2000));
+    mapPrg(2, 1, (regBankSelect & 0x40)? bank6 : secondLast);
+    mapPrg(3, 1, secondLast + 0x2000);
+    uint8_t chrHalf = (regBankSelect & 0x80)? 4 : 0;        // 2kB banks (R0, R1) and 1kB banks (R2 - R5) swap halves
+    mapChr(chrHalf ^ 0, 2, cart->chrROM + ((bankRegisters[0] & 0xFE) * 0x0400));
+    mapChr(chrHalf ^ 2, 2, cart->chrROM + ((bankRegisters[1] & 0xFE) * 0x0400));
+    for (uint8_t i = 0; i < 4; i++)
+        mapChr(chrHalf ^ (4 + i), 1, cart->chrROM + (bankRegisters[2 + i] * 0x0400));
+    if (ntMirror == mirror::fourScreen)     // ($A000 is ignored with four-screen VRAM on the cartridge)
+        mapNametables(mirror::fourScreen);
+    else
+        mapNametables((regMirror & 0x01)? mirror::horizontal : mirror::vertical);
+    updatePages();
+}
+
 #ifdef DEBUG
     uint8_t NES::Mapper4::cpuReadDebug(uint16_t addr)
     {
@@ -865,18 +806,7 @@ void NES::Mapper4::updateIrqCounter(uint16_t addr)
             }
         }
         else if (addr <= 0x3EFF)
-        {
-            addr &= 0x0FFF;
-            if (regMirror & 0x01)   // horizontal
-            {
-                if (addr <= 0x07FF)
-                    return NAMETABLE[addr & 0x03FF];
-                else
-                    return NAMETABLE[addr & 0x0BFF];
-            }
-            else                    // vertical
-                return NAMETABLE[addr & 0x07FF];
-        }
+            return ntSlot[(addr >> 10) & 0x03][addr & 0x03FF];
         return 0x00;
     }
 #endif
\ No newline at end of file
@@ -1,5 +1,5 @@
 #include "../include/Ricoh2A03.hpp"
-#include "../include/Memory.hpp"
+#include "../include/Bus.hpp"
 
 #include <iostream>
 #include <bitset>
@@ -10,7 +10,8 @@
        #include <iomanip>
 #endif
 
-ricoh2A03::CPU::CPU(NES::Memory *m) : mem(m)
+template<class Bus>
+ricoh2A03::CPU<Bus>::CPU(Bus *m) : mem(m)
 {
         #ifdef DEBUG
               CPUlogfile = std::ofstream("CPUlogfile.txt", std::ios_base::out);  // debug
@@ -18,7 +19,8 @@ ricoh2A03::CPU::CPU(NES::Memory *m) : mem(m)
         #endif
 }
 
-ricoh2A03::CPU::~CPU()
+template<class Bus>
+ricoh2A03::CPU<Bus>::~CPU()
 {
        #ifdef DEBUG
               CPUlogfile.close();
@@ -26,7 +28,8 @@ ricoh2A03::CPU::~CPU()
 }
 
 #ifdef DEBUG
-       void ricoh2A03::CPU::enableLog(bool enable)
+       template<class Bus>
+       void ricoh2A03::CPU<Bus>::enableLog(bool enable)
        {
               CPUlog = enable;
        }
@@ -34,77 +37,88 @@ ricoh2A03::CPU::~CPU()
 
 
 
-void ricoh2A03::CPU::tick(bool functional)
+template<class Bus>
+void ricoh2A03::CPU<Bus>::step()
 {
-       clock++;
-       if (!functional)
-              return;
-       if (insClk <= 0)
+       if (pendingNMI)
        {
-              if (pendingNMI)
-              {
-                     #ifdef DEBUG
-                            if (CPUlog)                                             // debug
-                                   CPUlogfile << "(NMI triggered)";                 // debug
-                     #endif
-                     mem->cpuWrite((0x0100 + SP), (uint8_t)((PC >> 8) & 0x00FF));
-                     SP--;
-                     mem->cpuWrite((0x0100 + SP), (uint8_t)(PC & 0x00FF));
-                     SP--;
-                     mem->cpuWrite((0x0100 + SP), STATUS);
-                     SP--;
-                     PC = (((uint16_t)(mem->cpuRead(0xFFFB)) << 8) | mem->cpuRead(0xFFFA));
-                     insClk = 8;
-              }
-              else if (pendingIRQ && !(STATUS & interruptDisable))
-              {
-                     #ifdef DEBUG
-                            if (CPUlog)                                             // debug
-                                   CPUlogfile << "(IRQ triggered)";                 // debug
-                     #endif
-                     mem->cpuWrite((0x0100 + SP), (uint8_t)((PC >> 8) & 0x00FF));
-                     SP--;
-                     mem->cpuWrite((0x0100 + SP), (uint8_t)(PC & 0x00FF));
-                     SP--;
-                     mem->cpuWrite((0x0100 + SP), STATUS);
-                     SP--;
-                     STATUS |= interruptDisable;
-                     PC = (((uint16_t)(mem->cpuRead(0xFFFF)) << 8) | mem->cpuRead(0xFFFE));
-                     insClk = 7;
-              }
-              else
-              {
+              #ifdef DEBUG
+                     if (CPUlog)                                             // debug
+                            CPUlogfile << "(NMI triggered)";                 // debug
+              #endif
+              mem->cpuWrite((0x0100 + SP), (uint8_t)((PC >> 8) & 0x00FF));
+              SP--;
+              mem->cpuWrite((0x0100 + SP), (uint8_t)(PC & 0x00FF));
+              SP--;
+              mem->cpuWrite((0x0100 + SP), STATUS);
+              SP--;
+              PC = (((uint16_t)(mem->cpuRead(0xFFFB)) << 8) | mem->cpuRead(0xFFFA));
+              insClk = 8;
+       }
+       else if (pendingIRQ && !(STATUS & interruptDisable))
+       {
+              #ifdef DEBUG
+                     if (CPUlog)                                             // debug
+                            CPUlogfile << "(IRQ triggered)";                 // debug
+              #endif
+              mem->cpuWrite((0x0100 + SP), (uint8_t)((PC >> 8) & 0x00FF));
+              SP--;
+              mem->cpuWrite((0x0100 + SP), (uint8_t)(PC & 0x00FF));
+              SP--;
+              mem->cpuWrite((0x0100 + SP), STATUS);
+              SP--;
+              STATUS |= interruptDisable;
+              PC = (((uint16_t)(mem->cpuRead(0xFFFF)) << 8) | mem->cpuRead(0xFFFE));
+              insClk = 7;
+       }
+       else
+       {
+              #ifdef DEBUG
+                     if (CPUlog)                                             // debug
+                            CPUlogfile << PC;                                // debug
+              #endif
+              instructions++;
+              #ifdef CPU_SWITCH_CORE
+                     uint8_t opcode = mem->cpuRead(PC++);
                      #ifdef DEBUG
-                            if (CPUlog)                                             // debug
-                                   CPUlogfile << PC;                                // debug
+                            if (CPUlog)                                                    // debug
+                                   CPUlogfile << ' ' << instructionSet[opcode].operation;  // debug (operands are not logged by this core)
                      #endif
+                     insClk = execute(opcode);
+              #else
                      currOp = &(instructionSet[mem->cpuRead(PC++)]);
                      #ifdef DEBUG
                             if (CPUlog)                                             // debug
                                    CPUlogfile << ' ' << currOp->operation;          // debug
                      #endif
-                     operandClk = (this->*currOp->addrMode)();
-                     processClk = (this->*currOp->operate)();
-                     insClk = (currOp->cycles) + operandClk + processClk;
-              }
-              #ifdef DEBUG
-                     if (CPUlog)                        // debug
-                            CPUlogfile << std::endl;    // debug
+                     insClk = (currOp->cycles) + (this->*currOp->exec)();
               #endif
-              pendingIRQ = false;
-              pendingNMI = false;
        }
-       insClk--;
+       #ifdef DEBUG
+              if (CPUlog)                        // debug
+                     CPUlogfile << std::endl;    // debug
+       #endif
+       pendingIRQ = false;
+       pendingNMI = false;
 }
 
 
-uint64_t ricoh2A03::CPU::getClock()
+template<class Bus>
+uint64_t ricoh2A03::CPU<Bus>::getClock()
 {
        return clock;
 }
 
 
-void ricoh2A03::CPU::rst()
+template<class Bus>
+uint64_t ricoh2A03::CPU<Bus>::getInstructions()
+{
+       return instructions;
+}
+
+
+template<class Bus>
+void ricoh2A03::CPU<Bus>::rst()
 {
        PC = (((uint16_t)(mem->cpuRead(0xFFFD)) << 8) | mem->cpuRead(0xFFFC));
        SP = 0xFF;
@@ -114,23 +128,28 @@ void ricoh2A03::CPU::rst()
        STATUS = 0x00;
        pendingIRQ = false;
        pendingNMI = false;
-       operandRef = nullptr;
-       operandAddr = -1;
+       jammed = false;
        insClk = 0;
        clock = 0;
+       instructions = 0;
 }
 
-void ricoh2A03::CPU::irq()
+template<class Bus>
+void ricoh2A03::CPU<Bus>::irq()
 {
-       pendingIRQ = true;
+       if (!jammed)
+              pendingIRQ = true;
 }
 
-void ricoh2A03::CPU::nmi()
+template<class Bus>
+void ricoh2A03::CPU<Bus>::nmi()
 {
-       pendingNMI = true;
+       if (!jammed)
+              pendingNMI = true;
 }
 
-bool ricoh2A03::CPU::instrDone()
+template<class Bus>
+bool ricoh2A03::CPU<Bus>::instrDone()
 {
        return (insClk == 0)? true : false;
 }
@@ -139,737 +158,480 @@ bool ricoh2A03::CPU::instrDone()
 
 
 
-uint8_t ricoh2A03::CPU::ACCUM()
-{
-       operandRef = &ACC;
-       operandAddr = -1;
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::IMM()
-{
-       operandRef = nullptr;
-       operandAddr = PC++;
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << " #$" << std::setw(2) << (int)(mem->cpuReadDebug(operandAddr));
-       #endif
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::ABS()
-{
-       operandRef = nullptr;
-       operandAddr = (((uint16_t)(mem->cpuRead(PC + 1)) << 8) | mem->cpuRead(PC));
-       PC += 2;
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << " $" << std::setw(4) << (int)(operandAddr);
-       #endif
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::ZP()
-{
-       operandRef = nullptr;
-       operandAddr = (0x0000 | mem->cpuRead(PC++));
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << " $" << std::setw(2) << (int)(operandAddr);
-       #endif
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::ZPX()
-{
-       operandRef = nullptr;
-       operandAddr = (0x00FF & (mem->cpuRead(PC++) + REGX));
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << " $" << std::setw(2) << (int)(operandAddr - REGX) << ",X";
-       #endif
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::ZPY()
-{
-       operandRef = nullptr;
-       operandAddr = (0x00FF & (mem->cpuRead(PC++) + REGY));
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << " $" << std::setw(2) << (int)(operandAddr - REGY) << ",Y";
-       #endif
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::ABSX()
-{
-       uint16_t buffer = (((uint16_t)(mem->cpuRead(PC + 1)) << 8) | mem->cpuRead(PC));
-       PC += 2;
-       operandRef = nullptr;
-       operandAddr = buffer + REGX;
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << " $" << std::setw(4) << (int)(buffer) << ",X";
-       #endif
-       if ((operandAddr & 0xFF00) == (buffer & 0xFF00))
-              return 0;
-       else
-              return currOp->pageDelay;
-}
-
-uint8_t ricoh2A03::CPU::ABSY()
-{
-       uint16_t buffer = (((uint16_t)(mem->cpuRead(PC + 1)) << 8) | mem->cpuRead(PC));
-       PC += 2;
-       operandRef = nullptr;
-       operandAddr = buffer + REGY;
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << " $" << std::setw(4) << (int)(buffer) << ",Y";
-       #endif
-       if ((operandAddr & 0xFF00) == (buffer & 0xFF00))
-              return 0;
-       else
-              return currOp->pageDelay;
-}
-
-uint8_t ricoh2A03::CPU::IMP()
-{
-       operandRef = nullptr;
-       operandAddr = -1;
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::REL()
-{
-       operandRef = nullptr;
-       operandAddr = PC++;
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << ' ' << std::setw(2) << (int)(mem->cpuReadDebug(operandAddr)) << ",Y";
-       #endif
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::INDX()
-{
-       uint8_t temp = mem->cpuRead(PC++);
-       uint8_t zpAddr = temp + REGX;
-       operandRef = nullptr;
-       operandAddr = (((uint16_t)(mem->cpuRead((zpAddr + 1) & 0x00FF)) << 8) | mem->cpuRead(zpAddr));
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << " ($" << std::setw(2) << (int)(temp) << ",X)";
-       #endif
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::INDY()
-{
-       uint8_t zpAddr = mem->cpuRead(PC++);
-       uint16_t buffer = (((uint16_t)(mem->cpuRead((zpAddr + 1) & 0x00FF)) << 8) | mem->cpuRead(zpAddr));
-       operandRef = nullptr;
-       operandAddr = buffer + REGY;
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << " ($" << std::setw(2) << (int)(zpAddr) << "),Y";
-       #endif
-       if((operandAddr & 0xFF00) == (buffer & 0xFF00))
-              return 0;
-       else
-              return currOp->pageDelay;
-}
-
-uint8_t ricoh2A03::CPU::IND()
-{
-       uint16_t addrToAddr = (((uint16_t)(mem->cpuRead(PC + 1)) << 8) | mem->cpuRead(PC));
-       operandRef = nullptr;
-       if(mem->cpuRead(PC) == 0xFF)
-              operandAddr = (((uint16_t)(mem->cpuRead(addrToAddr | 0xFF00)) << 8) | mem->cpuRead(addrToAddr));  
-       else
-              operandAddr = (((uint16_t)(mem->cpuRead(addrToAddr + 1)) << 8) | mem->cpuRead(addrToAddr));
-       PC += 2;
-       #ifdef DEBUG
-              if (CPUlog)
-                     CPUlogfile << " ($" << std::setw(4) << (int)(addrToAddr) << ")";
-       #endif
-       return 0;
-}
-
-
-
-
-
-uint8_t ricoh2A03::CPU::LDA()
-{
-       ACC = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       STATUS = (ACC == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (ACC & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::LDX()
-{
-       REGX = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       STATUS = (REGX == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (REGX & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::LDY()
-{
-       REGY = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       STATUS = (REGY == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (REGY & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::STA()
-{
-       if (operandRef)
-              *operandRef = ACC;
-       else
-              mem->cpuWrite(operandAddr, ACC);
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::STX()
-{
-       if (operandRef)
-              *operandRef = REGX;
-       else
-              mem->cpuWrite(operandAddr, REGX);
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::STY()
-{
-       if (operandRef)
-              *operandRef = REGY;
-       else
-              mem->cpuWrite(operandAddr, REGY);
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::TAX()
-{
-       REGX = ACC;
-       STATUS = (REGX == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (REGX & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::TAY()
-{
-       REGY = ACC;
-       STATUS = (REGY == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (REGY & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::TXA()
-{
-       ACC = REGX;
-       STATUS = (ACC == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (ACC & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::TYA()
-{
-       ACC = REGY;
-       STATUS = (ACC == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (ACC & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::TSX()
-{
-       REGX = SP;
-       STATUS = (REGX == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (REGX & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::TXS()
-{
-       SP = REGX;
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::PHA()
-{
-       mem->cpuWrite(0x0100 + SP, ACC);
-       SP--;
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::PHP()
-{
-       mem->cpuWrite(0x0100 + SP, (STATUS | breakCommand | unused));
-       SP--;
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::PLA()
-{
-       SP++;
-       ACC = mem->cpuRead(0x0100 + SP);
-       STATUS = (ACC == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (ACC & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::PLP()
-{
-       SP++;
-       STATUS = mem->cpuRead(0x0100 + SP);
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::AND()
-{
-       ACC &= (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       STATUS = (ACC == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (ACC & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::EOR()
-{
-       ACC ^= (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       STATUS = (ACC == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (ACC & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::ORA()
-{
-       ACC |= (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       STATUS = (ACC == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = (ACC & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::BIT()
-{
-       uint8_t operand = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       STATUS = (ACC & operand)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (operand & 0x40)? (STATUS | overflowFlag) : (STATUS & ~(overflowFlag));
-       STATUS = (operand & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::ADC()
+template<class Bus>
+template<ricoh2A03::addrMode M>
+inline uint16_t ricoh2A03::CPU<Bus>::address(uint8_t &cross)
 {
-       uint8_t operand = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       uint16_t buffer = (uint16_t)(ACC) + (uint16_t)(operand) + (uint16_t)((STATUS & carryFlag)? 1 : 0);
-       STATUS = (buffer & 0xFF00)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
-       STATUS = (buffer & 0x00FF)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (((uint16_t)(ACC) ^ ~(uint16_t)(operand)) & ((uint16_t)(ACC) ^ buffer) & 0x0080)? (STATUS | overflowFlag) : (STATUS & ~(overflowFlag));
-       STATUS = (buffer & 0x0080)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       ACC = (buffer & 0x00FF);
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::SBC()
-{
-       uint8_t operand = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       uint16_t buffer = (uint16_t)(ACC) + (uint16_t)(operand ^ 0xFF) + (uint16_t)((STATUS & carryFlag)? 1 : 0);       // carryFlag is "reverse-carry" here
-       STATUS = (buffer & 0xFF00)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
-       STATUS = (buffer & 0x00FF)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (((uint16_t)(ACC) ^ (uint16_t)(operand)) & ((uint16_t)(ACC) ^ buffer) & 0x0080)? (STATUS | overflowFlag) : (STATUS & ~(overflowFlag));
-       STATUS = (buffer & 0x0080)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       ACC = (buffer & 0x00FF);
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::CMP()
-{
-       uint8_t operand = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       STATUS = (ACC >= operand)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
-       STATUS = (ACC == operand)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = ((ACC - operand) & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::CPX()
-{
-       uint8_t operand = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       STATUS = (REGX >= operand)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
-       STATUS = (REGX == operand)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = ((REGX - operand) & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::CPY()
-{
-       uint8_t operand = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       STATUS = (REGY >= operand)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
-       STATUS = (REGY == operand)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
-       STATUS = ((REGY - operand) & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::INC()
-{
-       uint8_t operand;
-       if (operandRef)
+       if constexpr ((M == IMM) || (M == REL))
        {
-              (*operandRef)++;
-              operand = *operandRef;
+              #ifdef DEBUG
+                     if (CPUlog)
+                            CPUlogfile << ((M == IMM)? " #$" : " ") << std::setw(2) << (int)(mem->cpuReadDebug(PC));
+              #endif
+              return PC++;
        }
-       else
+       else if constexpr ((M == ZP) || (M == ZPX) || (M == ZPY))
        {
-              operand = mem->cpuRead(operandAddr) + 1;
-              mem->cpuWrite(operandAddr, operand);
+              uint8_t zpAddr = mem->cpuRead(PC++);
+              #ifdef DEBUG
+                     if (CPUlog)
+                            CPUlogfile << " $" << std::setw(2) << (int)(zpAddr) << ((M == ZPX)? ",X" : ((M == ZPY)? ",Y" : ""));
+              #endif
+              if constexpr (M == ZPX)
+                     zpAddr += REGX;
+              else if constexpr (M == ZPY)
+                     zpAddr += REGY;
+              return zpAddr;
        }
-       STATUS = (operand)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (operand & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::INX()
-{
-       REGX++;
-       STATUS = (REGX)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (REGX & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::INY()
-{
-       REGY++;
-       STATUS = (REGY)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (REGY & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::DEC()
-{
-       uint8_t operand;
-       if (operandRef)
+       else if constexpr ((M == ABS) || (M == ABSX) || (M == ABSY))
        {
-              (*operandRef)--;
-              operand = *operandRef;
+              uint16_t buffer = (((uint16_t)(mem->cpuRead(PC + 1)) << 8) | mem->cpuRead(PC));
+              PC += 2;
+              #ifdef DEBUG
+                     if (CPUlog)
+                            CPUlogfile << " $" << std::setw(4) << (int)(buffer) << ((M == ABSX)? ",X" : ((M == ABSY)? ",Y" : ""));
+              #endif
+              if constexpr (M == ABS)
+                     return buffer;
+              uint16_t addr = buffer + ((M == ABSX)? REGX : REGY);
+              cross = ((addr & 0xFF00) != (buffer & 0xFF00))? 1 : 0;
+              return addr;
        }
-       else
+       else if constexpr (M == IND)
        {
-              operand = mem->cpuRead(operandAddr) - 1;
-              mem->cpuWrite(operandAddr, operand);
+              uint16_t addrToAddr = (((uint16_t)(mem->cpuRead(PC + 1)) << 8) | mem->cpuRead(PC));
+              uint16_t addr;
+              if(mem->cpuRead(PC) == 0xFF)
+                     addr = (((uint16_t)(mem->cpuRead(addrToAddr | 0xFF00)) << 8) | mem->cpuRead(addrToAddr));
+              else
+                     addr = (((uint16_t)(mem->cpuRead(addrToAddr + 1)) << 8) | mem->cpuRead(addrToAddr));
+              PC += 2;
+              #ifdef DEBUG
+                     if (CPUlog)
+                            CPUlogfile << " ($" << std::setw(4) << (int)(addrToAddr) << ")";
+              #endif
+              return addr;
        }
-       STATUS = (operand)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (operand & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::DEX()
-{
-       REGX--;
-       STATUS = (REGX)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (REGX & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::DEY()
-{
-       REGY--;
-       STATUS = (REGY)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (REGY & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::ASL()
-{
-       uint8_t operand = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       uint16_t buffer = ((uint16_t)(operand) << 1);
-       STATUS = (buffer & 0xFF00)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
-       STATUS = (buffer & 0x00FF)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (buffer & 0x0080)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       if (operandRef)
-              *operandRef = (buffer & 0x00FF);
-       else
-              mem->cpuWrite(operandAddr, (buffer & 0x00FF));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::LSR()
-{
-       uint8_t operand = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       uint16_t buffer = ((uint16_t)(operand) >> 1);
-       STATUS = (operand & 0x01)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
-       STATUS = (buffer & 0x00FF)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (buffer & 0x0080)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       if (operandRef)
-              *operandRef = (buffer & 0x00FF);
-       else
-              mem->cpuWrite(operandAddr, (buffer & 0x00FF));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::ROL()
-{
-       uint8_t operand = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       uint16_t buffer = (((uint16_t)(operand) << 1) | ((STATUS & carryFlag)? 0x0001 : 0x0000));
-       STATUS = (buffer & 0xFF00)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
-       STATUS = (buffer & 0x00FF)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (buffer & 0x0080)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       if (operandRef)
-              *operandRef = (buffer & 0x00FF);
-       else
-              mem->cpuWrite(operandAddr, (buffer & 0x00FF));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::ROR()
-{
-       uint8_t operand = (operandRef)? *operandRef : mem->cpuRead(operandAddr);
-       uint16_t buffer = (((uint16_t)(operand) >> 1) | ((STATUS & carryFlag)? 0x0080 : 0x0000));
-       STATUS = (operand & 0x01)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
-       STATUS = (buffer & 0x00FF)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
-       STATUS = (buffer & 0x0080)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
-       if (operandRef)
-              *operandRef = (buffer & 0x00FF);
-       else
-              mem->cpuWrite(operandAddr, (buffer & 0x00FF));
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::JMP()
-{
-       PC = (uint16_t)(operandAddr & 0x0000FFFF);
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::JSR()
-{
-       PC--;
-       mem->cpuWrite(0x0100 + SP, (uint8_t)((PC >> 8) & 0x00FF));
-       SP--;
-       mem->cpuWrite(0x0100 + SP, (uint8_t)(PC & 0x00FF));
-       SP--;
-       PC = operandAddr;
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::RTS()
-{
-       SP++;
-       PC = mem->cpuRead(0x0100 + SP);
-       SP++;
-       PC |= ((uint16_t)(mem->cpuRead(0x0100 + SP)) << 8);
-       PC++;
-       return 0;
-}
-
-uint8_t ricoh2A03::CPU::BCC()
-{
-       if ((STATUS & carryFlag) || operandRef)
-              return 0;
-       else
+       else if constexpr (M == INDX)
        {
-              uint8_t addCycles = 1;
-              uint8_t operand = mem->cpuRead(operandAddr);
-              uint16_t operand16 = (operand & 0x80)? (0xFF00 | operand) : (0x0000 | operand);
-              if (((PC + operand16) & 0XFF00) != (PC & 0xFF00))
-                     addCycles++;
-              PC += operand16;     // overflow intended
-              return addCycles;
+              uint8_t temp = mem->cpuRead(PC++);
+              uint8_t zpAddr = temp + REGX;
+              #ifdef DEBUG
+                     if (CPUlog)
+                            CPUlogfile << " ($" << std::setw(2) << (int)(temp) << ",X)";
+              #endif
+              return (((uint16_t)(mem->cpuRead((zpAddr + 1) & 0x00FF)) << 8) | mem->cpuRead(zpAddr));
        }
-}
-
-uint8_t ricoh2A03::CPU::BCS()
-{
-       if ((STATUS & carryFlag) && !(operandRef))
+       else    // INDY
        {
-              uint8_t addCycles = 1;
-              uint8_t operand = mem->cpuRead(operandAddr);
-              uint16_t operand16 = (operand & 0x80)? (0xFF00 | operand) : (0x0000 | operand);
-              if (((PC + operand16) & 0XFF00) != (PC & 0xFF00))
-                     addCycles++;
-              PC += operand16;     // overflow intended
-              return addCycles;
+              uint8_t zpAddr = mem->cpuRead(PC++);
+              uint16_t buffer = (((uint16_t)(mem->cpuRead((zpAddr + 1) & 0x00FF)) << 8) | mem->cpuRead(zpAddr));
+              uint16_t addr = buffer + REGY;
+              #ifdef DEBUG
+                     if (CPUlog)
+                            CPUlogfile << " ($" << std::setw(2) << (int)(zpAddr) << "),Y";
+              #endif
+              cross = ((addr & 0xFF00) != (buffer & 0xFF00))? 1 : 0;
+              return addr;
        }
-       else
-              return 0;
 }
 
-uint8_t ricoh2A03::CPU::BEQ()
+template<class Bus>
+template<ricoh2A03::addrMode M, ricoh2A03::instrOp O>
+inline uint8_t ricoh2A03::CPU<Bus>::exec()
 {
-       if ((STATUS & zeroFlag) && !(operandRef))
+       if constexpr (M == IMP)
        {
-              uint8_t addCycles = 1;
-              uint8_t operand = mem->cpuRead(operandAddr);
-              uint16_t offset = (operand & 0x80)? (0xFF00 | operand) : (0x0000 | operand);
-              if (((PC + offset) & 0XFF00) != (PC & 0xFF00))
-                     addCycles++;
-              PC += offset;     // overflow intended
-              return addCycles;
-       }
-       else
+              implied<O>();
               return 0;
-}
-
-uint8_t ricoh2A03::CPU::BMI()
-{
-       if ((STATUS & negativeFlag) && !(operandRef))
+       }
+       else if constexpr (M == ACCUM)
        {
-              uint8_t addCycles = 1;
-              uint8_t operand = mem->cpuRead(operandAddr);
-              uint16_t offset = (operand & 0x80)? (0xFF00 | operand) : (0x0000 | operand);
-              if (((PC + offset) & 0XFF00) != (PC & 0xFF00))
-                     addCycles++;
-              PC += offset;     // overflow intended
-              return addCycles;
+              ACC = modify<O>(ACC);
+              return 0;
        }
        else
+       {
+              uint8_t cross = 0;
+              uint16_t addr = address<M>(cross);
+              if constexpr (M == REL)
+                     return branch(addr, taken<O>());
+              else if constexpr (O == JMP)
+                     PC = addr;
+              else if constexpr (O == JSR)
+              {
+                     PC--;
+                     push((uint8_t)((PC >> 8) & 0x00FF));
+                     push((uint8_t)(PC & 0x00FF));
+                     PC = addr;
+              }
+              else if constexpr (reads(O))
+              {
+                     load<O>(mem->cpuRead(addr));
+                     return cross;       // reads take 1 more cycle when indexing crosses a page
+              }
+              else if constexpr (writes(O))
+              {
+                     uint8_t data = store<O>();
+                     if constexpr ((O == XAHX) || (O == XSHX) || (O == XSHY) || (O == XTAS))
+                     {
+                            // value is ANDed with the high byte of the base address + 1, and replaces the high byte of the address on a page cross
+                            data &= (uint8_t)(((addr - ((M == ABSX)? REGX : REGY)) >> 8) + 1);
+                            if (cross)
+                                   addr = ((uint16_t)(data) << 8) | (addr & 0x00FF);
+                     }
+                     mem->cpuWrite(addr, data);
+              }
+              else
+                     mem->cpuWrite(addr, modify<O>(mem->cpuRead(addr)));
               return 0;
+       }
 }
 
-uint8_t ricoh2A03::CPU::BNE()
-{
-       if ((STATUS & zeroFlag) || operandRef)
-              return 0;
-       else
+template<class Bus>
+template<ricoh2A03::instrOp O>
+inline void ricoh2A03::CPU<Bus>::load(uint8_t operand)
+{
+       if constexpr (O == LDA)
+              setZN(ACC = operand);
+       else if constexpr (O == LDX)
+              setZN(REGX = operand);
+       else if constexpr (O == LDY)
+              setZN(REGY = operand);
+       else if constexpr (O == AND)
+              setZN(ACC &= operand);
+       else if constexpr (O == EOR)
+              setZN(ACC ^= operand);
+       else if constexpr (O == ORA)
+              setZN(ACC |= operand);
+       else if constexpr (O == BIT)
        {
-              uint8_t addCycles = 1;
-              uint8_t operand = mem->cpuRead(operandAddr);
-              uint16_t offset = (operand & 0x80)? (0xFF00 | operand) : (0x0000 | operand);
-              if (((PC + offset) & 0XFF00) != (PC & 0xFF00))
-                     addCycles++;
-              PC += offset;     // overflow intended
-              return addCycles;
+              STATUS = (ACC & operand)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
+              STATUS = (operand & 0x40)? (STATUS | overflowFlag) : (STATUS & ~(overflowFlag));
+              STATUS = (operand & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
        }
-}
-
-uint8_t ricoh2A03::CPU::BPL()
-{
-       if ((STATUS & negativeFlag) || operandRef)
-              return 0;
-       else
+       else if constexpr (O == ADC)
+              adc(operand);
+       else if constexpr ((O == SBC) || (O == XSBC))
+              adc(operand ^ 0xFF);
+       else if constexpr (O == CMP)
+              compare(ACC, operand);
+       else if constexpr (O == CPX)
+              compare(REGX, operand);
+       else if constexpr (O == CPY)
+              compare(REGY, operand);
+       else if constexpr (O == XLAX)
+              setZN(ACC = REGX = operand);
+       else if constexpr (O == XLXA)                     // unstable; uses the common 0xEE "magic" constant
+              setZN(ACC = REGX = ((ACC | 0xEE) & operand));
+       else if constexpr (O == XLAS)
+              setZN(ACC = REGX = SP = (operand & SP));
+       else if constexpr (O == XANC)
        {
-              uint8_t addCycles = 1;
-              uint8_t operand = mem->cpuRead(operandAddr);
-              uint16_t offset = (operand & 0x80)? (0xFF00 | operand) : (0x0000 | operand);
-              if (((PC + offset) & 0XFF00) != (PC & 0xFF00))
-                     addCycles++;
-              PC += offset;     // overflow intended
-              return addCycles;
+              setZN(ACC &= operand);
+              STATUS = (ACC & 0x80)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
        }
-}
-
-uint8_t ricoh2A03::CPU::BVC()
-{
-       if ((STATUS & overflowFlag) || operandRef)
-              return 0;
-       else
+       else if constexpr (O == XALR)
+              ACC = lsr(ACC & operand);
+       else if constexpr (O == XARR)
        {
-              uint8_t addCycles = 1;
-              uint8_t operand = mem->cpuRead(operandAddr);
-              uint16_t offset = (operand & 0x80)? (0xFF00 | operand) : (0x0000 | operand);
-              if (((PC + offset) & 0XFF00) != (PC & 0xFF00))
-                     addCycles++;
-              PC += offset;     // overflow intended
-              return addCycles;
+              ACC = (((ACC & operand) >> 1) | ((STATUS & carryFlag)? 0x80 : 0x00));
+              setZN(ACC);
+              STATUS = (ACC & 0x40)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
+              STATUS = (((ACC >> 6) ^ (ACC >> 5)) & 0x01)? (STATUS | overflowFlag) : (STATUS & ~(overflowFlag));
+       }
+       else if constexpr (O == XAXS)
+       {
+              uint8_t buffer = ACC & REGX;
+              STATUS = (buffer >= operand)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
+              setZN(REGX = buffer - operand);
+       }
+       else if constexpr (O == XXAA)                     // unstable; uses the common 0xEE "magic" constant
+              setZN(ACC = ((ACC | 0xEE) & REGX & operand));
+       else if constexpr (O == XNOP) {}                  // operand is read and discarded
+}
+
+template<class Bus>
+template<ricoh2A03::instrOp O>
+inline uint8_t ricoh2A03::CPU<Bus>::store()
+{
+       if constexpr (O == STA)
+              return ACC;
+       else if constexpr (O == STX)
+              return REGX;
+       else if constexpr (O == STY)
+              return REGY;
+       else if constexpr ((O == XSAX) || (O == XAHX))
+              return ACC & REGX;
+       else if constexpr (O == XSHX)
+              return REGX;
+       else if constexpr (O == XSHY)
+              return REGY;
+       else    // XTAS
+       {
+              SP = ACC & REGX;
+              return SP;
        }
 }
 
-uint8_t ricoh2A03::CPU::BVS()
-{
-       if ((STATUS & overflowFlag) && !(operandRef))
+template<class Bus>
+template<ricoh2A03::instrOp O>
+inline uint8_t ricoh2A03::CPU<Bus>::modify(uint8_t operand)
+{
+       uint8_t result;
+       if constexpr ((O == ASL) || (O == XSLO))
+              result = asl(operand);
+       else if constexpr ((O == LSR) || (O == XSRE))
+              result = lsr(operand);
+       else if constexpr ((O == ROL) || (O == XRLA))
+              result = rol(operand);
+       else if constexpr ((O == ROR) || (O == XRRA))
+              result = ror(operand);
+       else if constexpr ((O == INC) || (O == XISC))
+              result = operand + 1;
+       else    // DEC, XDCP
+              result = operand - 1;
+
+       if constexpr ((O == INC) || (O == DEC))
+              setZN(result);
+       else if constexpr (O == XSLO)
+              setZN(ACC |= result);
+       else if constexpr (O == XRLA)
+              setZN(ACC &= result);
+       else if constexpr (O == XSRE)
+              setZN(ACC ^= result);
+       else if constexpr (O == XRRA)
+              adc(result);
+       else if constexpr (O == XDCP)
+              compare(ACC, result);
+       else if constexpr (O == XISC)
+              adc(result ^ 0xFF);
+       return result;
+}
+
+template<class Bus>
+template<ricoh2A03::instrOp O>
+inline void ricoh2A03::CPU<Bus>::implied()
+{
+       if constexpr (O == TAX)
+              setZN(REGX = ACC);
+       else if constexpr (O == TAY)
+              setZN(REGY = ACC);
+       else if constexpr (O == TXA)
+              setZN(ACC = REGX);
+       else if constexpr (O == TYA)
+              setZN(ACC = REGY);
+       else if constexpr (O == TSX)
+              setZN(REGX = SP);
+       else if constexpr (O == TXS)
+              SP = REGX;
+       else if constexpr (O == PHA)
+              push(ACC);
+       else if constexpr (O == PHP)
+              push(STATUS | breakCommand | unused);
+       else if constexpr (O == PLA)
+              setZN(ACC = pull());
+       else if constexpr (O == PLP)
+              STATUS = pull();
+       else if constexpr (O == INX)
+              setZN(++REGX);
+       else if constexpr (O == INY)
+              setZN(++REGY);
+       else if constexpr (O == DEX)
+              setZN(--REGX);
+       else if constexpr (O == DEY)
+              setZN(--REGY);
+       else if constexpr (O == RTS)
        {
-              uint8_t addCycles = 1;
-              uint8_t operand = mem->cpuRead(operandAddr);
-              uint16_t offset = (operand & 0x80)? (0xFF00 | operand) : (0x0000 | operand);
-              if (((PC + offset) & 0XFF00) != (PC & 0xFF00))
-                     addCycles++;
-              PC += offset;     // overflow intended
-              return addCycles;
+              PC = pull();
+              PC |= ((uint16_t)(pull()) << 8);
+              PC++;
        }
-       else
-              return 0;
+       else if constexpr (O == CLC)
+              STATUS &= ~(carryFlag);
+       else if constexpr (O == CLD)
+              STATUS &= ~(decimalMode);
+       else if constexpr (O == CLI)
+              STATUS &= ~(interruptDisable);
+       else if constexpr (O == CLV)
+              STATUS &= ~(overflowFlag);
+       else if constexpr (O == SEC)
+              STATUS |= carryFlag;
+       else if constexpr (O == SED)
+              STATUS |= decimalMode;
+       else if constexpr (O == SEI)
+              STATUS |= interruptDisable;
+       else if constexpr (O == BRK)
+       {
+              PC++;  // RTI will go to the address of the BRK +2
+              push((uint8_t)((PC >> 8) & 0x00FF));
+              push((uint8_t)(PC & 0x00FF));
+              push(STATUS);
+              PC = (((uint16_t)(mem->cpuRead(0xFFFF)) << 8) | (mem->cpuRead(0xFFFE)));
+              STATUS |= breakCommand;
+       }
+       else if constexpr (O == RTI)
+       {
+              STATUS = pull();
+              PC = pull();
+              PC |= ((uint16_t)(pull()) << 8);
+              #ifdef DEBUG
+                     if (CPUlog)                               // debug
+                            CPUlogfile << " (RTI here)";       // debug
+              #endif
+       }
+       else if constexpr (O == XSTP)
+       {
+              PC--;     // jams by fetching itself forever (only a reset gets out, as on hardware)
+              jammed = true;
+       }
+       else if constexpr ((O == NOP) || (O == XNOP)) {}
 }
 
-uint8_t ricoh2A03::CPU::CLC()
+template<class Bus>
+template<ricoh2A03::instrOp O>
+inline bool ricoh2A03::CPU<Bus>::taken()
 {
-       STATUS &= ~(carryFlag);
-       return 0;
+       if constexpr (O == BCC)
+              return !(STATUS & carryFlag);
+       else if constexpr (O == BCS)
+              return (STATUS & carryFlag);
+       else if constexpr (O == BEQ)
+              return (STATUS & zeroFlag);
+       else if constexpr (O == BNE)
+              return !(STATUS & zeroFlag);
+       else if constexpr (O == BMI)
+              return (STATUS & negativeFlag);
+       else if constexpr (O == BPL)
+              return !(STATUS & negativeFlag);
+       else if constexpr (O == BVC)
+              return !(STATUS & overflowFlag);
+       else    // BVS
+              return (STATUS & overflowFlag);
 }
 
-uint8_t ricoh2A03::CPU::CLD()
+template<class Bus>
+inline void ricoh2A03::CPU<Bus>::setZN(uint8_t value)
 {
-       STATUS &= ~(decimalMode);
-       return 0;
+       STATUS = (value == 0x00)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
+       STATUS = (value & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
 }
 
-uint8_t ricoh2A03::CPU::CLI()
+template<class Bus>
+inline void ricoh2A03::CPU<Bus>::push(uint8_t data)
 {
-       STATUS &= ~(interruptDisable);
-       return 0;
+       mem->cpuWrite(0x0100 + SP, data);
+       SP--;
 }
 
-uint8_t ricoh2A03::CPU::CLV()
+template<class Bus>
+inline uint8_t ricoh2A03::CPU<Bus>::pull()
 {
-       STATUS &= ~(overflowFlag);
-       return 0;
+       SP++;
+       return mem->cpuRead(0x0100 + SP);
 }
 
-uint8_t ricoh2A03::CPU::SEC()
+template<class Bus>
+inline void ricoh2A03::CPU<Bus>::adc(uint8_t operand)
 {
-       STATUS |= carryFlag;
-       return 0;
+       uint16_t buffer = (uint16_t)(ACC) + (uint16_t)(operand) + (uint16_t)((STATUS & carryFlag)? 1 : 0);
+       STATUS = (buffer & 0xFF00)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
+       STATUS = (buffer & 0x00FF)? (STATUS & ~(zeroFlag)) : (STATUS | zeroFlag);
+       STATUS = (((uint16_t)(ACC) ^ ~(uint16_t)(operand)) & ((uint16_t)(ACC) ^ buffer) & 0x0080)? (STATUS | overflowFlag) : (STATUS & ~(overflowFlag));
+       STATUS = (buffer & 0x0080)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
+       ACC = (buffer & 0x00FF);
 }
 
-uint8_t ricoh2A03::CPU::SED()
+template<class Bus>
+inline void ricoh2A03::CPU<Bus>::compare(uint8_t reg, uint8_t operand)
 {
-       STATUS |= decimalMode;
-       return 0;
+       STATUS = (reg >= operand)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
+       STATUS = (reg == operand)? (STATUS | zeroFlag) : (STATUS & ~(zeroFlag));
+       STATUS = ((reg - operand) & 0x80)? (STATUS | negativeFlag) : (STATUS & ~(negativeFlag));
 }
 
-uint8_t ricoh2A03::CPU::SEI()
+template<class Bus>
+inline uint8_t ricoh2A03::CPU<Bus>::asl(uint8_t operand)
 {
-       STATUS |= interruptDisable;
-       return 0;
+       STATUS = (operand & 0x80)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
+       operand <<= 1;
+       setZN(operand);
+       return operand;
 }
 
-uint8_t ricoh2A03::CPU::BRK()
+template<class Bus>
+inline uint8_t ricoh2A03::CPU<Bus>::lsr(uint8_t operand)
 {
-       PC++;  // RTI will go to the address of the BRK +2
-       mem->cpuWrite(0x0100 + SP, (uint8_t)((PC >> 8) & 0x00FF));
-       SP--;
-       mem->cpuWrite(0x0100 + SP, (uint8_t)(PC & 0x00FF));
-       SP--;
-       mem->cpuWrite(0x0100 + SP, STATUS);
-       SP--;
-       PC = (((uint16_t)(mem->cpuRead(0xFFFF)) << 8) | (mem->cpuRead(0xFFFE)));
-       STATUS |= breakCommand;
-       return 0;
+       STATUS = (operand & 0x01)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
+       operand >>= 1;
+       setZN(operand);
+       return operand;
 }
 
-uint8_t ricoh2A03::CPU::NOP()
+template<class Bus>
+inline uint8_t ricoh2A03::CPU<Bus>::rol(uint8_t operand)
 {
-       return 0;
+       uint8_t result = ((operand << 1) | ((STATUS & carryFlag)? 0x01 : 0x00));
+       STATUS = (operand & 0x80)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
+       setZN(result);
+       return result;
 }
 
-uint8_t ricoh2A03::CPU::RTI()
+template<class Bus>
+inline uint8_t ricoh2A03::CPU<Bus>::ror(uint8_t operand)
 {
-       SP++;
-       STATUS = mem->cpuRead(0x0100 + SP);
-       SP++;
-       PC = (0x0000 | mem->cpuRead(0x0100 + SP));
-       SP++;
-       PC |= ((uint16_t)(mem->cpuRead(0x0100 + SP)) << 8);
-       #ifdef DEBUG
-              if (CPUlog)                               // debug
-                     CPUlogfile << " (RTI here)";       // debug
-       #endif
-       return 0;
+       uint8_t result = ((operand >> 1) | ((STATUS & carryFlag)? 0x80 : 0x00));
+       STATUS = (operand & 0x01)? (STATUS | carryFlag) : (STATUS & ~(carryFlag));
+       setZN(result);
+       return result;
 }
 
-uint8_t ricoh2A03::CPU::XXX()
+template<class Bus>
+inline uint8_t ricoh2A03::CPU<Bus>::branch(uint16_t operandAddr, bool taken)
 {
-       return 0;
-}
+       if (!taken)
+              return 0;
+       uint8_t addCycles = 1;
+       uint8_t operand = mem->cpuRead(operandAddr);
+       uint16_t offset = (operand & 0x80)? (0xFF00 | operand) : (0x0000 | operand);
+       if (((PC + offset) & 0XFF00) != (PC & 0xFF00))
+              addCycles++;
+       PC += offset;     // overflow intended
+       return addCycles;
+}
+
+#ifdef CPU_SWITCH_CORE
+       // every case is a compile-time constant entry of instructionSet[], so its handler is called directly
+       #define CPU_OPCODE(n)          case (n): return instructionSet[(n)].cycles + (this->*instructionSet[(n)].exec)();
+       #define CPU_OPCODE4(n)         CPU_OPCODE(n) CPU_OPCODE((n) + 1) CPU_OPCODE((n) + 2) CPU_OPCODE((n) + 3)
+       #define CPU_OPCODE16(n)        CPU_OPCODE4(n) CPU_OPCODE4((n) + 4) CPU_OPCODE4((n) + 8) CPU_OPCODE4((n) + 12)
+       #define CPU_OPCODE64(n)        CPU_OPCODE16(n) CPU_OPCODE16((n) + 16) CPU_OPCODE16((n) + 32) CPU_OPCODE16((n) + 48)
+
+       template<class Bus>
+       uint8_t ricoh2A03::CPU<Bus>::execute(uint8_t opcode)
+       {
+              switch (opcode)
+              {
+                     CPU_OPCODE64(0x00)
+                     CPU_OPCODE64(0x40)
+                     CPU_OPCODE64(0x80)
+                     CPU_OPCODE64(0xC0)
+              }
+              return 0;
+       }
+
+       #undef CPU_OPCODE64
+       #undef CPU_OPCODE16
+       #undef CPU_OPCODE4
+       #undef CPU_OPCODE
+#endif
+
 
 
+// one CPU per bus it can be wired to (see NES::Console::initCartridge())
+template class ricoh2A03::CPU<NES::Bus<NES::Mapper0>>;
+template class ricoh2A03::CPU<NES::Bus<NES::Mapper1>>;
+template class ricoh2A03::CPU<NES::Bus<NES::Mapper2>>;
+template class ricoh2A03::CPU<NES::Bus<NES::Mapper3>>;
+template class ricoh2A03::CPU<NES::Bus<NES::Mapper4>>;
+template class ricoh2A03::CPU<NES::Memory>;     // gtests and NES_CPUBench
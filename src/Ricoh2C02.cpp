@@ -1,12 +1,208 @@
 #include "../include/Ricoh2C02.hpp"
-#include "../include/Memory.hpp"
+#include "../include/Bus.hpp"
+#include "../include/Scheduler.hpp"
 #include <cstring>
+#include <algorithm>
 
 #include <iostream>
 
-ricoh2C02::PPU::PPU(NES::Memory *m) : mem(m)
+static const uint8_t dotStep[3] = {2, 3, 1};    // phases from each dot of a CPU cycle to the next dot (dots on phases 1, 3 and 5)
+
+// ricoh2C02::DOTaction flags for each dot of each kind of scanline (see PPU::tick())
+// kinds: 0 visible (0-239), 1 post-render (240), 2 vblank start (241), 3 vblank (242-260), 4 pre-render (261)
+struct DotTable
+{
+    uint8_t lineKind[262];
+    uint32_t actions[5][341];
+};
+
+static DotTable buildDotTable()
+{
+    using namespace ricoh2C02;
+    static const uint16_t kindLine[5] = {0, 240, 241, 242, 261};
+    DotTable table = {};
+    for (uint16_t y = 0; y < 262; y++)
+        table.lineKind[y] = (y <= 239)? 0 : ((y == 240)? 1 : ((y == 241)? 2 : ((y == 261)? 4 : 3)));
+    for (uint8_t kind = 0; kind < 5; kind++)
+    {
+        uint16_t y = kindLine[kind];
+        for (uint16_t x = 0; x <= 340; x++)
+        {
+            uint32_t a = 0;
+            if ((y <= 239) || (y == 261))
+            {
+                if ((x <= 256) || ((x >= 320) && (x <= 336)))
+                {
+                    if (x && (x != 320))
+                        a |= shiftBackground;
+                    switch (x & 0x0007)
+                    {
+                        case 0: a |= fetchNametable; break;
+                        case 1: a |= reloadBackground | ((x == 1)? ((y == 261)? clearStatus : oddFrameFetch) : 0); break;
+                        case 2: a |= fetchAttribute; break;
+                        case 4: a |= fetchPatternLow; break;
+                        case 6: a |= fetchPatternHigh; break;
+                        default: break;
+                    }
+                }
+                else if (x == 257)
+                    a |= reloadBackground;
+                else if (x == 338)
+                    a |= fetchNametable;
+
+                if (x == 1)
+                    a |= rasterizeLine | clearSecondaryOAM;
+                else if (x == 65)
+                    a |= spriteEvaluation;
+                else if (x == 257)
+                    a |= advanceShifters;
+                if ((x >= 1) && (x <= 256))
+                    a |= spriteFromLine;
+                if ((x >= 257) && (x <= 320))
+                    a |= loadSprites | resetOAMaddr;
+
+                if ((((x >= 1) && (x <= 256)) || ((x >= 321) && (x <= 336))) && ((x & 0x07) == 0x07))
+                    a |= (x != 255)? scrollHorizontal : scrollVertical;
+                else if (x == 257)
+                    a |= copyHorizontal;
+                else if ((y == 261) && (x >= 280) && (x <= 304))
+                    a |= copyVertical;
+            }
+            if ((y < 240) && (x >= 1) && (x <= 256))
+                a |= drawPixel;
+            if ((y == 241) && (x == 1))
+                a |= setVblank;
+            table.actions[kind][x] = a;
+        }
+    }
+    return table;
+}
+
+static const DotTable dotTable = buildDotTable();
+
+// background and sprite priority for a whole scanline (see PPU::renderScanline())
+// inputs are 256 palette addresses each, plus 0xFF/0x00 lines for sprite priority (behind background) and for dots where a sprite 0 pixel may hit
+// writes the final palette addresses and returns the first dot (1-256) of a sprite 0 hit, or 0 if there is none
+typedef uint16_t (*muxLineFunc)(const uint8_t *bg, const uint8_t *spr, const uint8_t *sprBehind, const uint8_t *sprZero, uint8_t *out);
+
+static uint16_t muxLineScalar(const uint8_t *bg, const uint8_t *spr, const uint8_t *sprBehind, const uint8_t *sprZero, uint8_t *out)
+{
+    uint16_t hitDot = 0;
+    for (uint16_t i = 0; i < 256; i++)
+    {
+        bool bgOpaque = bg[i] & 0x03, sprOpaque = spr[i] & 0x03;
+        out[i] = (sprOpaque && !(bgOpaque && sprBehind[i]))? spr[i] : ((bgOpaque)? bg[i] : 0x00);
+        if (bgOpaque && sprOpaque && sprZero[i] && !hitDot)
+            hitDot = i + 1;
+    }
+    return hitDot;
+}
+
+// palette indices (6-bit colours) to RGB24 through a table of 64 entries of R, G, B, 0 (see PPU::getScreen())
+typedef void (*indicesToRGBFunc)(const uint8_t *indices, uint8_t *rgb, const uint32_t *palette, uint32_t count);
+
+static void indicesToRGBScalar(const uint8_t *indices, uint8_t *rgb, const uint32_t *palette, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+        memcpy(rgb + (i * 3), palette + (indices[i] & 0x3F), 3);
+}
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+// 16 and 32 dots at a time; same result as muxLineScalar() (compiled for their instruction set only, picked at runtime below)
+__attribute__((target("sse4.1")))
+static uint16_t muxLineSSE41(const uint8_t *bg, const uint8_t *spr, const uint8_t *sprBehind, const uint8_t *sprZero, uint8_t *out)
+{
+    const __m128i pixelBits = _mm_set1_epi8(0x03), zero = _mm_setzero_si128();
+    uint16_t hitDot = 0;
+    for (uint16_t i = 0; i < 256; i += 16)
+    {
+        __m128i b = _mm_loadu_si128((const __m128i*)(bg + i));
+        __m128i s = _mm_loadu_si128((const __m128i*)(spr + i));
+        __m128i bgClear = _mm_cmpeq_epi8(_mm_and_si128(b, pixelBits), zero);
+        __m128i sprClear = _mm_cmpeq_epi8(_mm_and_si128(s, pixelBits), zero);
+        __m128i sprFront = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(sprBehind + i)), zero);
+        __m128i useSpr = _mm_andnot_si128(sprClear, _mm_or_si128(bgClear, sprFront));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_blendv_epi8(_mm_andnot_si128(bgClear, b), s, useSpr));
+        int hits = _mm_movemask_epi8(_mm_andnot_si128(_mm_or_si128(bgClear, sprClear), _mm_loadu_si128((const __m128i*)(sprZero + i))));
+        if (hits && !hitDot)
+            hitDot = i + __builtin_ctz(hits) + 1;
+    }
+    return hitDot;
+}
+
+__attribute__((target("avx2")))
+static uint16_t muxLineAVX2(const uint8_t *bg, const uint8_t *spr, const uint8_t *sprBehind, const uint8_t *sprZero, uint8_t *out)
+{
+    const __m256i pixelBits = _mm256_set1_epi8(0x03), zero = _mm256_setzero_si256();
+    uint16_t hitDot = 0;
+    for (uint16_t i = 0; i < 256; i += 32)
+    {
+        __m256i b = _mm256_loadu_si256((const __m256i*)(bg + i));
+        __m256i s = _mm256_loadu_si256((const __m256i*)(spr + i));
+        __m256i bgClear = _mm256_cmpeq_epi8(_mm256_and_si256(b, pixelBits), zero);
+        __m256i sprClear = _mm256_cmpeq_epi8(_mm256_and_si256(s, pixelBits), zero);
+        __m256i sprFront = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(sprBehind + i)), zero);
+        __m256i useSpr = _mm256_andnot_si256(sprClear, _mm256_or_si256(bgClear, sprFront));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_blendv_epi8(_mm256_andnot_si256(bgClear, b), s, useSpr));
+        uint32_t hits = (uint32_t)(_mm256_movemask_epi8(_mm256_andnot_si256(_mm256_or_si256(bgClear, sprClear), _mm256_loadu_si256((const __m256i*)(sprZero + i)))));
+        if (hits && !hitDot)
+            hitDot = i + __builtin_ctz(hits) + 1;
+    }
+    return hitDot;
+}
+
+// 8 pixels at a time: gather their table entries, then pack the 4 byte entries down to 3 bytes within each 128-bit half
+__attribute__((target("avx2")))
+static void indicesToRGBAVX2(const uint8_t *indices, uint8_t *rgb, const uint32_t *palette, uint32_t count)
 {
-    screenBuffer = new uint8_t[256 * 240 * 3]{0};   // 341 * 262 cycles though
+    const __m256i pack = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                          0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m256i colorBits = _mm256_set1_epi32(0x3F);
+    uint32_t i = 0;
+    for (; (i + 10) <= count; i += 8)   // each step stores 4 bytes past its 24 (overwritten by the next step; the tail is left to the scalar loop)
+    {
+        __m256i index = _mm256_and_si256(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(indices + i))), colorBits);
+        __m256i pixels = _mm256_shuffle_epi8(_mm256_i32gather_epi32((const int*)(palette), index, 4), pack);
+        _mm_storeu_si128((__m128i*)(rgb + (i * 3)), _mm256_castsi256_si128(pixels));
+        _mm_storeu_si128((__m128i*)(rgb + (i * 3) + 12), _mm256_extracti128_si256(pixels, 1));
+    }
+    indicesToRGBScalar(indices + i, rgb + (i * 3), palette, count - i);
+}
+
+static muxLineFunc pickMuxLine()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return muxLineAVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return muxLineSSE41;
+    return muxLineScalar;
+}
+
+static indicesToRGBFunc pickIndicesToRGB()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return indicesToRGBAVX2;
+    return indicesToRGBScalar;
+}
+#else
+static muxLineFunc pickMuxLine() {return muxLineScalar;}
+static indicesToRGBFunc pickIndicesToRGB() {return indicesToRGBScalar;}
+#endif
+
+static const muxLineFunc muxLine = pickMuxLine();
+static const indicesToRGBFunc indicesToRGB = pickIndicesToRGB();
+
+template<class Bus>
+ricoh2C02::PPU<Bus>::PPU(Bus *m, NES::Scheduler *s) : mem(m), scheduler(s)
+{
+    screenIndices = new uint8_t[256 * 240]{0};      // 341 * 262 cycles though
+    screenBuffer = new uint8_t[256 * 240 * 3]{0};
+    for (uint8_t i = 0; i < 64; i++)
+        memcpy(paletteRGBX + i, paletteRGB + i, 3);
     #ifdef DEBUG
         chr = new uint8_t[128 * 256 * 3]{0};
         oam = new uint8_t[64 * 128 * 3]{0};
@@ -16,8 +212,10 @@ ricoh2C02::PPU::PPU(NES::Memory *m) : mem(m)
     OAMsecondary = new uint8_t[8 * 4]{0};
 }
 
-ricoh2C02::PPU::~PPU()
+template<class Bus>
+ricoh2C02::PPU<Bus>::~PPU()
 {
+    delete[] screenIndices;
     delete[] screenBuffer;
     #ifdef DEBUG
         delete[] chr;
@@ -29,7 +227,8 @@ ricoh2C02::PPU::~PPU()
 }
 
 #ifdef DEBUG
-    uint8_t* const ricoh2C02::PPU::getChrROM()
+    template<class Bus>
+    uint8_t* const ricoh2C02::PPU<Bus>::getChrROM()
     {
         memset(chr, 0x00, 128 * 256 * 3 * sizeof(uint8_t));
         const uint8_t palette = 0x00;                       // placeholder assuming palette ID is 0
@@ -70,7 +269,8 @@ ricoh2C02::PPU::~PPU()
         return chr;
     }
 
-    uint8_t* const ricoh2C02::PPU::getOAM()
+    template<class Bus>
+    uint8_t* const ricoh2C02::PPU<Bus>::getOAM()
     {
         memset(oam, 0x00, 64 * 128 * 3 * sizeof(uint8_t));
         for (int y = 0; y < 8; y++)
@@ -125,7 +325,8 @@ ricoh2C02::PPU::~PPU()
         return oam;
     }
 
-    uint8_t* const ricoh2C02::PPU::getNT()
+    template<class Bus>
+    uint8_t* const ricoh2C02::PPU<Bus>::getNT()
     {
         memset(nt, 0x00, 256 * 240 * 4 * 3 * sizeof(uint8_t));
         for (uint16_t ntNum = 0; ntNum < 4; ntNum++)
@@ -179,10 +380,9 @@ ricoh2C02::PPU::~PPU()
     }
 #endif
 
-void ricoh2C02::PPU::rst()
+template<class Bus>
+void ricoh2C02::PPU<Bus>::rst()
 {
-    frameDone = false;
-    NMI = false;
     PPUCTRLpost30000 = 0x0000;
     PPUDATAbuffer = 0x00;
     screenX = 0;
@@ -194,17 +394,20 @@ void ricoh2C02::PPU::rst()
     writeToggle = false;
     bgPalette1shifter = 0x00;
     bgPalette0shifter = 0x00;
-    bgMSBshifter = 0x0000;
-    bgLSBshifter = 0x0000;
+    bgPatternShifter = 0x00000000;
     bgPalette1Latch = false;
     bgPalette0Latch = false;
     bgNextTileID = 0x00;
     bgNextTileAttr = 0x00;
-    bgNextMSB = 0x00;
-    bgNextLSB = 0x00;
+    bgNextPattern = 0x0000;
+    renderedAhead = false;
+    nextDotTime = scheduler->now + 1;
+    dotInCycle = 0;
+    scheduleSync();
 }
 
-uint8_t ricoh2C02::PPU::cpuRead(uint16_t addr)
+template<class Bus>
+uint8_t ricoh2C02::PPU<Bus>::cpuRead(uint16_t addr)
 {
     if ((addr & 0xFFF8) == 0x2000)
     {
@@ -233,6 +436,8 @@ uint8_t ricoh2C02::PPU::cpuRead(uint16_t addr)
             case 6:     // PPUADDR (only write)
                 break;
             case 7:     // PPUDATA (read and write)
+                if (renderedAhead)
+                    redoScanline();
                 if (vramAddrCurr < 0x3F00)
                 {
                     data = PPUDATAbuffer;
@@ -240,7 +445,7 @@ uint8_t ricoh2C02::PPU::cpuRead(uint16_t addr)
                 }
                 else
                 {
-                    PPUDATAbuffer= mem->ppuRead(vramAddrCurr);
+                    PPUDATAbuffer= ((vramAddrCurr & 0x3FFF) >= 0x3F00)? palette[vramAddrCurr & 0x001F] : mem->ppuRead(vramAddrCurr);
                     data = PPUDATAbuffer;
                 }
                 vramAddrCurr = (vramAddrCurr + ((registers[0] & PPUCTRLmask::vramIncrement)? 32 : 1)) & 0x7FFF;
@@ -253,7 +458,8 @@ uint8_t ricoh2C02::PPU::cpuRead(uint16_t addr)
     return 0x00;
 }
 
-bool ricoh2C02::PPU::cpuWrite(uint16_t addr, uint8_t data)
+template<class Bus>
+bool ricoh2C02::PPU<Bus>::cpuWrite(uint16_t addr, uint8_t data)
 {
     if ((addr & 0xFFF8) == 0x2000)
     {
@@ -276,7 +482,14 @@ bool ricoh2C02::PPU::cpuWrite(uint16_t addr, uint8_t data)
                 registers[3] = data;
                 break;
             case 4:     // OAMDATA (read and write)
-                OAMprimary[registers[3]] = data;
+                if (!(registers[3] & 0x03) && lineSpritesHeight)   // Y position moves the sprite to other lines
+                {
+                    indexSprite(registers[3] >> 2, false);
+                    OAMprimary[registers[3]] = data;
+                    indexSprite(registers[3] >> 2, true);
+                }
+                else
+                    OAMprimary[registers[3]] = data;
                 registers[3]++;
                 break;
             case 5:     // PPUSCROLL (only write)
@@ -308,7 +521,10 @@ bool ricoh2C02::PPU::cpuWrite(uint16_t addr, uint8_t data)
                 return true;
                 break;
             case 7:     // PPUDATA (read and write)
-                mem->ppuWrite(vramAddrCurr, data);
+                if ((vramAddrCurr & 0x3FFF) >= 0x3F00)
+                    paletteWrite(vramAddrCurr, data);
+                else
+                    mem->ppuWrite(vramAddrCurr, data);
                 vramAddrCurr = (vramAddrCurr + ((registers[0] & PPUCTRLmask::vramIncrement)? 32 : 1)) & 0x7FFF;
                 return true;
                 break;
@@ -328,7 +544,8 @@ bool ricoh2C02::PPU::cpuWrite(uint16_t addr, uint8_t data)
 }
 
 #ifdef DEBUG
-    uint8_t ricoh2C02::PPU::cpuReadDebug(uint16_t addr)
+    template<class Bus>
+    uint8_t ricoh2C02::PPU<Bus>::cpuReadDebug(uint16_t addr)
     {
         if ((addr & 0xFFF8) == 0x2000)
             return registers[addr & 0x0007];
@@ -341,7 +558,8 @@ bool ricoh2C02::PPU::cpuWrite(uint16_t addr, uint8_t data)
 
 
 
-bool ricoh2C02::PPU::DMAtransfer()
+template<class Bus>
+bool ricoh2C02::PPU<Bus>::DMAtransfer()
 {
     if (DMAaddr < 256)
     {
@@ -355,250 +573,377 @@ bool ricoh2C02::PPU::DMAtransfer()
 
 
 
+template<class Bus>
+inline void ricoh2C02::PPU<Bus>::incrementHorizontal()
+{
+    if ((vramAddrCurr & VRAMmask::coarseX) == 31)
+    {
+        vramAddrCurr &= ~(VRAMmask::coarseX);
+        vramAddrCurr ^= VRAMmask::nametableID0;
+    }
+    else
+        vramAddrCurr++;
+}
+
+template<class Bus>
+inline void ricoh2C02::PPU<Bus>::incrementVertical()
+{
+    vramAddrCurr = (vramAddrCurr + 0x1000) & 0x7FFF;
+    if (!(vramAddrCurr & VRAMmask::fineY))
+    {
+        uint8_t coarseY = (vramAddrCurr & VRAMmask::coarseY) >> 5;
+        if (coarseY == 29)
+        {
+            vramAddrCurr &= ~(VRAMmask::coarseY);
+            vramAddrCurr ^= VRAMmask::nametableID1;
+        }
+        else if (coarseY == 31)
+        {
+            vramAddrCurr &= ~(VRAMmask::coarseY);
+        }
+        else
+            vramAddrCurr += 0x0020; // increment coarseY
+    }
+}
+
+template<class Bus>
+void ricoh2C02::PPU<Bus>::indexSprite(uint8_t n, bool inRange)
+{
+    uint64_t bit = (uint64_t)(1) << n;
+    uint16_t lastLine = OAMprimary[n * 4] + lineSpritesHeight - 1;
+    for (uint16_t line = OAMprimary[n * 4]; (line <= lastLine) && (line <= 240); line++)
+        lineSprites[line] = (inRange)? (lineSprites[line] | bit) : (lineSprites[line] & ~bit);
+}
+
+template<class Bus>
+inline void ricoh2C02::PPU<Bus>::backgroundPixels(uint8_t *colorAddr, uint8_t dots, bool enabled)
+{
+    if (enabled)
+    {
+        // palette shifters with 8 more dots of their latches behind them, all lined up on fineX
+        uint16_t palette1 = ((bgPalette1shifter << 8) | ((bgPalette1Latch)? 0xFF : 0x00)) << fineX;
+        uint16_t palette0 = ((bgPalette0shifter << 8) | ((bgPalette0Latch)? 0xFF : 0x00)) << fineX;
+        uint32_t pattern = bgPatternShifter << (fineX << 1);
+        for (uint8_t i = 0; i < dots; i++)
+        {
+            colorAddr[i] = ((palette1 >> 12) & 0x08) | ((palette0 >> 13) & 0x04) | (pattern >> 30);
+            palette1 <<= 1;
+            palette0 <<= 1;
+            pattern <<= 2;
+        }
+    }
+    else
+        memset(colorAddr, 0x00, dots);
+    bgPatternShifter <<= (dots << 1);
+    bgPalette1shifter = (bgPalette1shifter << dots) | ((bgPalette1Latch)? (0xFF >> (8 - dots)) : 0x00);
+    bgPalette0shifter = (bgPalette0shifter << dots) | ((bgPalette0Latch)? (0xFF >> (8 - dots)) : 0x00);
+}
+
+template<class Bus>
+void ricoh2C02::PPU<Bus>::rasterizeSprites()
+{
+    memset(sprLineColor, 0x00, sizeof(sprLineColor));
+    sprDot = 0;
+    for (int i = sprToRender - 1; i >= 0; i--)
+    {
+        uint8_t paletteAddr = ((sprAttrLatch[i] & OAMmask::byte2PaletteID) + 0x04) << 2;
+        uint8_t behind = (sprAttrLatch[i] & OAMmask::byte2Priority)? 0xFF : 0x00;
+        for (uint8_t p = 0; p < 8; p++)
+        {
+            uint8_t color = (sprPatternShifter[i] >> (14 - (p << 1))) & 0x03;
+            if (color)
+            {
+                sprLineColor[sprPosX[i] + p] = paletteAddr + color;
+                sprLineBehind[sprPosX[i] + p] = behind;
+                sprLineZero[sprPosX[i] + p] = (i == 0)? 0xFF : 0x00;
+            }
+        }
+    }
+}
+
+template<class Bus>
+void ricoh2C02::PPU<Bus>::advanceSprites()
+{
+    for (uint8_t i = 0; i < sprToRender; i++)
+    {
+        if (sprPosX[i] >= sprDot)
+            sprPosX[i] -= sprDot;
+        else
+        {
+            uint16_t shifts = sprDot - sprPosX[i];
+            sprPatternShifter[i] = (shifts < 8)? (sprPatternShifter[i] << (shifts << 1)) : 0x0000;
+            sprPosX[i] = 0;
+        }
+    }
+    sprDot = 0;
+}
+
+template<class Bus>
+inline void ricoh2C02::PPU<Bus>::evaluateSprites()
+{
+    uint16_t OAMoffset = registers[3];
+    uint8_t n = 0, m = 0, n2 = 0;
+    if (!OAMoffset)     // sprites come straight from the index; only the overflow check below (after 8 sprites) still walks OAM
+    {
+        uint8_t height = (registers[0] & PPUCTRLmask::spriteSize)? 16 : 8;
+        if (lineSpritesHeight != height)
+        {
+            memset(lineSprites, 0, sizeof(lineSprites));
+            lineSpritesHeight = height;
+            for (uint8_t i = 0; i < 64; i++)
+                indexSprite(i, true);
+        }
+        uint64_t inRange = lineSprites[(screenY == 261)? 0 : (screenY + 1)];
+        while (inRange && (n2 < 8))
+        {
+            while (!(inRange & 0x01))
+            {
+                inRange >>= 1;
+                n++;
+            }
+            memcpy(OAMsecondary + (n2 * 4), OAMprimary + (n * 4), 4);
+            if (n == 0)
+                nxtRenderSprite0 = true;
+            nxtSprToRender++;
+            n2++;
+            inRange >>= 1;
+            n++;
+        }
+        if (n2 < 8)
+        {
+            if (!(lineSprites[(screenY == 261)? 0 : (screenY + 1)] >> 63))
+                OAMsecondary[n2 * 4] = OAMprimary[63 * 4];  // (Y of the last sprite checked is left in the next free slot)
+            return;
+        }
+    }
+    while ((n2 < 8) && ((OAMoffset + (n * 4) + 3) < 256))
+    {
+        OAMsecondary[n2 * 4] = OAMprimary[OAMoffset + (n * 4)];
+        int16_t diffY = (int16_t)((screenY == 261)? 0 : (screenY + 1)) - (int16_t)(OAMprimary[n * 4]);
+        if ((diffY >= 0) && (diffY < ((registers[0] & PPUCTRLmask::spriteSize)? 16 : 8)))
+        {
+            OAMsecondary[(n2 * 4) + 1] = OAMprimary[OAMoffset + (n * 4) + 1];
+            OAMsecondary[(n2 * 4) + 2] = OAMprimary[OAMoffset + (n * 4) + 2];
+            OAMsecondary[(n2 * 4) + 3] = OAMprimary[OAMoffset + (n * 4) + 3];
+            nxtSprToRender++;
+            if (n == 0)
+                nxtRenderSprite0 = true;
+            n2++;
+        }
+        n++;
+    }
+    while ((OAMoffset + (n * 4) + m) < 256)     // note how we increment m for the hardware bug for sprite overflow check
+    {
+        int16_t diffY = (int16_t)((screenY == 261)? 0 : (screenY + 1)) - (int16_t)(OAMprimary[OAMoffset + (n * 4) + m]);
+        m = (m + 1) & 0x03;
+        if ((diffY >= 0) && (diffY < ((registers[0] & PPUCTRLmask::spriteSize)? 16 : 8)))
+        {
+            registers[2] |= PPUSTATUSmask::spriteOverflowFlag;
+            m += 3;
+            if (m >= 4)
+            {
+                n++;
+                m &= 0x03;
+            }
+        }
+        else
+        {
+            n++;
+            m = (m + 1) & 0x03;
+        }
+    }
+}
+
+
+
 // see https://wiki.nesdev.com/w/index.php/PPU_rendering
 // and https://wiki.nesdev.com/w/images/d/d1/Ntsc_timing.png
 // and https://wiki.nesdev.com/w/index.php/PPU_sprite_evaluation
 // note: cycle timing for ppu reads and vram addr increments are 1 cycle faster to mimic address line being set before actual read happens
 // (dunno if above is 100% true, but done just to get mapper 4 to work)
-void ricoh2C02::PPU::tick()
+template<class Bus>
+void ricoh2C02::PPU<Bus>::tick()
 {
     // -------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
     // background here
     // -------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    const uint32_t actions = dotTable.actions[dotTable.lineKind[screenY]][screenX];
     uint8_t bgColorAddr = 0x00;
     if (registers[1] & PPUMASKmask::showBackground)
     {
         bgColorAddr = ((bgPalette1shifter & (0x80 >> fineX))? 0x08 : 0x00)
                     + ((bgPalette0shifter & (0x80 >> fineX))? 0x04 : 0x00)
-                    + ((bgMSBshifter & (0x8000 >> fineX))? 0x02 : 0x00)
-                    + ((bgLSBshifter & (0x8000 >> fineX))? 0x01 : 0x00);
+                    + ((bgPatternShifter >> (30 - (fineX << 1))) & 0x03);
     }
-    if ((screenY <= 239) || (screenY == 261))   // for visible scanlines
+    if (actions & DOTaction::shiftBackground)
     {
-        if (((screenX >= 0) && (screenX <= 256)) || ((screenX >= 320) && (screenX <= 336)))
-        {
-            if ((screenX) && (screenX != 320))
-            {
-                bgPalette1shifter = (bgPalette1shifter << 1) | ((bgPalette1Latch)? 0x01 : 0x00);
-                bgPalette0shifter = (bgPalette0shifter << 1) | ((bgPalette0Latch)? 0x01 : 0x00);
-                bgMSBshifter <<= 1;
-                bgLSBshifter <<= 1;
-            }
-            switch (screenX & 0x0007)       // preloading data for next tile / 8 pixels
-            {                               // note each ppuRead case is 1 cycle early as address line seems to be set before actual read occurs?
-                case 0:
-                    // get next tile sprite ID
-                    if ((screenX != 256) || (screenX != 320))
-                        bgNextTileID = mem->ppuRead(0x2000 | (vramAddrCurr & 0x0FFF));
-                    break;
-                case 1:
-                    if ((screenY == 0) && oddFrame && (screenX == 1))
-                        bgNextTileID = mem->ppuRead(0x2000 | (vramAddrCurr & 0x0FFF));
-                    bgPalette1Latch = (bgNextTileAttr & 0x02)? true : false;
-                    bgPalette0Latch = (bgNextTileAttr & 0x01)? true : false;
-                    bgMSBshifter |= bgNextMSB;
-                    bgLSBshifter |= bgNextLSB;
-                    if ((screenY == 261) && (screenX == 1)) // clear vblank, sprite 0, and overflow flags
-                        registers[2] &= ~(PPUSTATUSmask::sprite0HitFlag | PPUSTATUSmask::spriteOverflowFlag | PPUSTATUSmask::vblankFlag);
-                    break;
-                case 2:
-                    // AT byte
-                    bgNextTileAttr = mem->ppuRead(0x23C0 | (vramAddrCurr & VRAMmask::nametableID)
-                                                         | (((vramAddrCurr & VRAMmask::coarseY) >> 4) & 0x0038)     // >> 5 >> 2 << 3
-                                                         | ((vramAddrCurr & VRAMmask::coarseX) >> 2));
-                    if (vramAddrCurr & VRAMmask::coarseY & 0x0040)
-                        bgNextTileAttr >>= 4;
-                    if (vramAddrCurr & VRAMmask::coarseX & 0x0002)
-                        bgNextTileAttr >>= 2;
-                    break;
-                case 4:
-                    // get next tile LSB
-                    bgNextLSB = mem->ppuRead(((registers[0] & PPUCTRLmask::backgroundPatternTable)? 0x1000 : 0x0000)
-                                             + (bgNextTileID << 4)
-                                             + ((vramAddrCurr & VRAMmask::fineY) >> 12));
-                    break;
-                case 6:
-                    // get next tile MSB
-                    bgNextMSB = mem->ppuRead(((registers[0] & PPUCTRLmask::backgroundPatternTable)? 0x1000 : 0x0000)
-                                             + (bgNextTileID << 4)
-                                             + ((vramAddrCurr & VRAMmask::fineY) >> 12)
-                                             + 8);
-                    break;
-                default:
-                    break;
-            }
-        }
-        else if (screenX == 257)
-        {
-            bgPalette1Latch = (bgNextTileAttr & 0x02)? true : false;
-            bgPalette0Latch = (bgNextTileAttr & 0x01)? true : false;
-            bgMSBshifter |= bgNextMSB;
-            bgLSBshifter |= bgNextLSB;
-        }
-        else if ((screenX == 338))  // || (screenX == 340))
-        {
+        bgPalette1shifter = (bgPalette1shifter << 1) | ((bgPalette1Latch)? 0x01 : 0x00);
+        bgPalette0shifter = (bgPalette0shifter << 1) | ((bgPalette0Latch)? 0x01 : 0x00);
+        bgPatternShifter <<= 2;
+    }
+    // preloading data for next tile / 8 pixels
+    // note each ppuRead is 1 cycle early as address line seems to be set before actual read occurs?
+    if (actions & DOTaction::fetchNametable)
+    {
+        // get next tile sprite ID
+        bgNextTileID = mem->ppuRead(0x2000 | (vramAddrCurr & 0x0FFF));
+    }
+    else if (actions & DOTaction::reloadBackground)
+    {
+        if ((actions & DOTaction::oddFrameFetch) && (screenY == 0) && oddFrame)
             bgNextTileID = mem->ppuRead(0x2000 | (vramAddrCurr & 0x0FFF));
-        }
+        bgPalette1Latch = (bgNextTileAttr & 0x02)? true : false;
+        bgPalette0Latch = (bgNextTileAttr & 0x01)? true : false;
+        bgPatternShifter |= bgNextPattern;
+        if (actions & DOTaction::clearStatus)   // clear vblank, sprite 0, and overflow flags
+            registers[2] &= ~(PPUSTATUSmask::sprite0HitFlag | PPUSTATUSmask::spriteOverflowFlag | PPUSTATUSmask::vblankFlag);
+    }
+    else if (actions & DOTaction::fetchAttribute)
+    {
+        // AT byte
+        bgNextTileAttr = mem->ppuRead(0x23C0 | (vramAddrCurr & VRAMmask::nametableID)
+                                             | (((vramAddrCurr & VRAMmask::coarseY) >> 4) & 0x0038)     // >> 5 >> 2 << 3
+                                             | ((vramAddrCurr & VRAMmask::coarseX) >> 2));
+        if (vramAddrCurr & VRAMmask::coarseY & 0x0040)
+            bgNextTileAttr >>= 4;
+        if (vramAddrCurr & VRAMmask::coarseX & 0x0002)
+            bgNextTileAttr >>= 2;
+    }
+    else if (actions & DOTaction::fetchPatternLow)
+    {
+        // get next tile LSB (bit 0 of each decoded pixel)
+        bgNextPattern = mem->ppuTile(((registers[0] & PPUCTRLmask::backgroundPatternTable)? 0x1000 : 0x0000)
+                                     + (bgNextTileID << 4)
+                                     + ((vramAddrCurr & VRAMmask::fineY) >> 12))[0] & 0x5555;
+    }
+    else if (actions & DOTaction::fetchPatternHigh)
+    {
+        // get next tile MSB (bit 1 of each decoded pixel)
+        bgNextPattern |= mem->ppuTile(((registers[0] & PPUCTRLmask::backgroundPatternTable)? 0x1000 : 0x0000)
+                                      + (bgNextTileID << 4)
+                                      + ((vramAddrCurr & VRAMmask::fineY) >> 12)
+                                      + 8)[0] & 0xAAAA;
     }
 
     // -------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
     // sprites here
     // -------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
     uint8_t sprColorAddr = 0x00;
-    int currSprInShifter = -1;
+    bool sprBehind = false, sprZeroPixel = false;
+    if (actions & DOTaction::rasterizeLine)
+        rasterizeSprites();
+    else if (actions & DOTaction::advanceShifters)
+        advanceSprites();
     if (registers[1] & PPUMASKmask::showSprites)
     {
-        for (uint8_t i = 0; i < sprToRender; i++)
+        if (actions & DOTaction::spriteFromLine)
         {
-            if (!(sprPosX[i]))
+            sprColorAddr = sprLineColor[sprDot];
+            sprBehind = sprLineBehind[sprDot];
+            sprZeroPixel = sprLineZero[sprDot];
+            sprDot++;
+        }
+        else if (bgColorAddr & 0x03)    // (off the line buffer, a sprite pixel can only matter for a sprite 0 hit)
+        {
+            for (uint8_t i = 0; i < sprToRender; i++)
             {
-                uint8_t color = ((sprMSBshifter[i] & 0x80)? 0x02 : 0x00)
-                              + ((sprLSBshifter[i] & 0x80)? 0x01 : 0x00);
-                if (color)
+                if (!(sprPosX[i]))
                 {
-                    sprColorAddr = (((sprAttrLatch[i] & OAMmask::byte2PaletteID) + 0x04) << 2) + color;
-                    currSprInShifter = i;
-                    break;
+                    uint8_t color = sprPatternShifter[i] >> 14;
+                    if (color)
+                    {
+                        sprColorAddr = (((sprAttrLatch[i] & OAMmask::byte2PaletteID) + 0x04) << 2) + color;
+                        sprBehind = sprAttrLatch[i] & OAMmask::byte2Priority;
+                        sprZeroPixel = (i == 0);
+                        break;
+                    }
                 }
             }
         }
     }
-    if ((screenY <= 239) || (screenY == 261))   // for visible scanlines
+    if ((actions & DOTaction::advanceShifters) && (registers[1] & PPUMASKmask::showSprites))     // (dots 1-256 were counted in sprDot)
     {
-        if ((registers[1] & PPUMASKmask::showSprites) && screenX && (screenX <= 257))
+        for (int i = 0; i < sprToRender; i++)
         {
-            for (int i = 0; i < sprToRender; i++)
+            if (sprPosX[i] > 0)
+                sprPosX[i]--;
+            else
             {
-                if (sprPosX[i] > 0)
-                    sprPosX[i]--;
-                else
-                {
-                    sprMSBshifter[i] <<= 1;
-                    sprLSBshifter[i] <<= 1;
-                }
+                sprPatternShifter[i] <<= 2;
             }
         }
-        if (screenX == 1)       // ((screenX >= 1) && (screenX <= 64))      // clear secondary OAM
-        {                       // (coalesced since everything is internal)
-            memset(OAMsecondary, 0xFF, 8 * 4 * sizeof(uint8_t));
-            nxtSprToRender = 0;
-            nxtRenderSprite0 = false;
-        }
-        else if (screenX == 65) // ((screenX >= 65) && (screenX <= 256))    // load secondary OAM
-        {                       // 192 ppu clock cycles (3 cycles per entry in primary OAM) (coalesced since everything is internal)
-            uint16_t OAMoffset = registers[3];
-            uint8_t n = 0, m = 0, n2 = 0;
-            while ((n2 < 8) && ((OAMoffset + (n * 4) + 3) < 256))
-            {
-                OAMsecondary[n2 * 4] = OAMprimary[OAMoffset + (n * 4)];
-                int16_t diffY = (int16_t)((screenY == 261)? 0 : (screenY + 1)) - (int16_t)(OAMprimary[n * 4]);
-                if ((diffY >= 0) && (diffY < ((registers[0] & PPUCTRLmask::spriteSize)? 16 : 8)))
-                {
-                    OAMsecondary[(n2 * 4) + 1] = OAMprimary[OAMoffset + (n * 4) + 1];
-                    OAMsecondary[(n2 * 4) + 2] = OAMprimary[OAMoffset + (n * 4) + 2];
-                    OAMsecondary[(n2 * 4) + 3] = OAMprimary[OAMoffset + (n * 4) + 3];
-                    nxtSprToRender++;
-                    if (n == 0)
-                        nxtRenderSprite0 = true;
-                    n2++;
-                }
-                n++;
-            }
-            while ((OAMoffset + (n * 4) + m) < 256)     // note how we increment m for the hardware bug for sprite overflow check
+    }
+    if (actions & DOTaction::clearSecondaryOAM)         // ((screenX >= 1) && (screenX <= 64))      // clear secondary OAM
+    {                                                   // (coalesced since everything is internal)
+        memset(OAMsecondary, 0xFF, 8 * 4 * sizeof(uint8_t));
+        nxtSprToRender = 0;
+        nxtRenderSprite0 = false;
+    }
+    else if (actions & DOTaction::spriteEvaluation)     // ((screenX >= 65) && (screenX <= 256))    // load secondary OAM
+        evaluateSprites();  // 192 ppu clock cycles (3 cycles per entry in primary OAM) (coalesced since everything is internal)
+    else if (actions & DOTaction::loadSprites)          // load data from secondary OAM into shifters?
+    {                                                   // 64 ppu clock cycles (8 cycles per entry in secondary OAM) (not completely accurate; just assumed ppuRead occurs every 4 ppu cycles)
+        if (screenX == 257)
+        {
+            sprToRender = nxtSprToRender;
+            renderSprite0 = nxtRenderSprite0;
+            currSpriteinOAM2 = 0;
+        }
+        if (currSpriteinOAM2 < nxtSprToRender)
+        {
+            switch (screenX & 0x0007)
             {
-                int16_t diffY = (int16_t)((screenY == 261)? 0 : (screenY + 1)) - (int16_t)(OAMprimary[OAMoffset + (n * 4) + m]);
-                m = (m + 1) & 0x03;
-                if ((diffY >= 0) && (diffY < ((registers[0] & PPUCTRLmask::spriteSize)? 16 : 8)))
-                {
-                    registers[2] |= PPUSTATUSmask::spriteOverflowFlag;
-                    m += 3;
-                    if (m >= 4)
+                case 1:
+                    tileRow = (uint8_t)((screenY == 261)? 0 : (screenY + 1)) - OAMsecondary[currSpriteinOAM2 * 4];
+                    if (registers[0] & PPUCTRLmask::spriteSize) // 8x16 sprite mode
                     {
-                        n++;
-                        m &= 0x03;
+                        patTableAddr = ((OAMsecondary[(currSpriteinOAM2 * 4) + 1] & OAMmask::byte1Bank)? 0x1000 : 0x0000);
+                        tileID = OAMsecondary[(currSpriteinOAM2 * 4) + 1] & OAMmask::byte1TileID;
+                        if (OAMsecondary[(currSpriteinOAM2 * 4) + 2] & OAMmask::byte2FlipVert)     // flip sprite veritcally
+                            tileRow = 15 - tileRow;
+                        if (tileRow >= 8)
+                        {
+                            tileRow -= 8;
+                            tileID++;
+                        }
                     }
-                }
-                else
-                {
-                    n++;
-                    m = (m + 1) & 0x03;
-                }
+                    else    // 8x8 sprite mode
+                    {
+                        patTableAddr = (registers[0] & PPUCTRLmask::spritePatternTable8x8Addr)? 0x1000 : 0x0000;
+                        tileID = OAMsecondary[(currSpriteinOAM2 * 4) + 1];
+                        if (OAMsecondary[(currSpriteinOAM2 * 4) + 2] & OAMmask::byte2FlipVert)      // flip sprite vertically
+                            tileRow = 7 - tileRow;
+                    }
+                    break;
+                case 4:
+                    // decoded row flipped horizontally or not ([1] or [0])
+                    sprPatternShifter[currSpriteinOAM2] = mem->ppuTile(patTableAddr + (tileID << 4) + tileRow)
+                                                          [(OAMsecondary[(currSpriteinOAM2 * 4) + 2] & OAMmask::byte2FlipHoriz)? 1 : 0] & 0x5555;
+                    break;
+                case 0:
+                    sprPatternShifter[currSpriteinOAM2] |= mem->ppuTile(patTableAddr + (tileID << 4) + tileRow + 8)
+                                                           [(OAMsecondary[(currSpriteinOAM2 * 4) + 2] & OAMmask::byte2FlipHoriz)? 1 : 0] & 0xAAAA;
+                    sprAttrLatch[currSpriteinOAM2] = OAMsecondary[(currSpriteinOAM2 * 4) + 2];
+                    sprPosX[currSpriteinOAM2] = OAMsecondary[(currSpriteinOAM2 * 4) + 3];
+                    currSpriteinOAM2++;
+                    break;
+                default:
+                    break;
             }
         }
-        else if ((screenX >= 257) && (screenX <= 320))  // load data from secondary OAM into shifters?
-        {                                               // 64 ppu clock cycles (8 cycles per entry in secondary OAM) (not completely accurate; just assumed ppuRead occurs every 4 ppu cycles)
-            if (screenX == 257)
+        else    // edge case: is there is no sprite to load, scanline counting for Mapper 4 fails
+        {       // ("dirty" trick to get Mapper 4 to work) (address line A12 actively in use even when no sprites are to be rendered next frame) (so, we use dummy writes to mimic this)
+            switch(screenX & 0x0007)
             {
-                sprToRender = nxtSprToRender;
-                renderSprite0 = nxtRenderSprite0;
-                currSpriteinOAM2 = 0;
-            }
-            if (currSpriteinOAM2 < nxtSprToRender)
-            {
-                switch (screenX & 0x0007)
-                {
-                    case 1:
-                        tileRow = (uint8_t)((screenY == 261)? 0 : (screenY + 1)) - OAMsecondary[currSpriteinOAM2 * 4];
-                        if (registers[0] & PPUCTRLmask::spriteSize) // 8x16 sprite mode
-                        {
-                            patTableAddr = ((OAMsecondary[(currSpriteinOAM2 * 4) + 1] & OAMmask::byte1Bank)? 0x1000 : 0x0000);
-                            tileID = OAMsecondary[(currSpriteinOAM2 * 4) + 1] & OAMmask::byte1TileID;
-                            if (OAMsecondary[(currSpriteinOAM2 * 4) + 2] & OAMmask::byte2FlipVert)     // flip sprite veritcally
-                                tileRow = 15 - tileRow;
-                            if (tileRow >= 8)
-                            {
-                                tileRow -= 8;
-                                tileID++;
-                            }
-                        }
-                        else    // 8x8 sprite mode
-                        {
-                            patTableAddr = (registers[0] & PPUCTRLmask::spritePatternTable8x8Addr)? 0x1000 : 0x0000;
-                            tileID = OAMsecondary[(currSpriteinOAM2 * 4) + 1];
-                            if (OAMsecondary[(currSpriteinOAM2 * 4) + 2] & OAMmask::byte2FlipVert)      // flip sprite vertically
-                                tileRow = 7 - tileRow;
-                        }
-                        break;
-                    case 4:
-                        sprLSBshifter[currSpriteinOAM2] = mem->ppuRead(patTableAddr + (tileID << 4) + tileRow);
-                        break;
-                    case 0:
-                        sprMSBshifter[currSpriteinOAM2] = mem->ppuRead(patTableAddr + (tileID << 4) + tileRow + 8);
-                        if (OAMsecondary[(currSpriteinOAM2 * 4) + 2] & OAMmask::byte2FlipHoriz)         // flip sprite horizontally
-                        {
-                            uint8_t toFlip = sprLSBshifter[currSpriteinOAM2];
-                            toFlip = (toFlip & 0xF0) >> 4 | (toFlip & 0x0F) << 4;
-                            toFlip = (toFlip & 0xCC) >> 2 | (toFlip & 0x33) << 2;
-                            toFlip = (toFlip & 0xAA) >> 1 | (toFlip & 0x55) << 1;
-                            sprLSBshifter[currSpriteinOAM2] = toFlip;
-                            toFlip = sprMSBshifter[currSpriteinOAM2];
-                            toFlip = (toFlip & 0xF0) >> 4 | (toFlip & 0x0F) << 4;
-                            toFlip = (toFlip & 0xCC) >> 2 | (toFlip & 0x33) << 2;
-                            toFlip = (toFlip & 0xAA) >> 1 | (toFlip & 0x55) << 1;
-                            sprMSBshifter[currSpriteinOAM2] = toFlip;
-                        }
-                        sprAttrLatch[currSpriteinOAM2] = OAMsecondary[(currSpriteinOAM2 * 4) + 2];
-                        sprPosX[currSpriteinOAM2] = OAMsecondary[(currSpriteinOAM2 * 4) + 3];
-                        currSpriteinOAM2++;
-                        break;
-                    default:
-                        break;
-                }
-            }
-            else    // edge case: is there is no sprite to load, scanline counting for Mapper 4 fails
-            {       // ("dirty" trick to get Mapper 4 to work) (address line A12 actively in use even when no sprites are to be rendered next frame) (so, we use dummy writes to mimic this)
-                switch(screenX & 0x0007)
-                {
-                    case 0:
-                    case 4:
-                        if (registers[0] & PPUCTRLmask::spriteSize) // 8x8 sprite mode
-                            mem->ppuRead(0x1FF0);   // see "https://wiki.nesdev.org/w/index.php?title=MMC3#IRQ_Specifics"? (not 100% correct. but close enough)
-                        else
-                            mem->ppuRead((registers[0] & PPUCTRLmask::spritePatternTable8x8Addr)? 0x1000 : 0x0000);
-                        break;
-                    default:
-                        break;
-                }
+                case 0:
+                case 4:
+                    if (registers[0] & PPUCTRLmask::spriteSize) // 8x8 sprite mode
+                        mem->ppuRead(0x1FF0);   // see "https://wiki.nesdev.org/w/index.php?title=MMC3#IRQ_Specifics"? (not 100% correct. but close enough)
+                    else
+                        mem->ppuRead((registers[0] & PPUCTRLmask::spritePatternTable8x8Addr)? 0x1000 : 0x0000);
+                    break;
+                default:
+                    break;
             }
         }
     }
@@ -611,12 +956,12 @@ void ricoh2C02::PPU::tick()
     {
         if (sprColorAddr & 0x03)
         {
-            if (sprAttrLatch[currSprInShifter] & OAMmask::byte2Priority)
+            if (sprBehind)
                 colorAddr = bgColorAddr;
             else
                 colorAddr = sprColorAddr;
             bool renderBackgroundAndSprites = ((registers[1] & (PPUMASKmask::showBackground | PPUMASKmask::showSprites)) == (PPUMASKmask::showBackground | PPUMASKmask::showSprites));
-            if (renderSprite0 && (currSprInShifter == 0) && renderBackgroundAndSprites)
+            if (renderSprite0 && sprZeroPixel && renderBackgroundAndSprites)
             {
                 // sprite 0 collision (https://wiki.nesdev.com/w/index.php?title=PPU_OAM&redirect=no#Sprite_zero_hits)
                 uint8_t leftmostTile = (registers[1] & (PPUMASKmask::showLeftmostBackground | PPUMASKmask::showLeftmostSprite));
@@ -630,69 +975,35 @@ void ricoh2C02::PPU::tick()
     else if (sprColorAddr & 0x03)
         colorAddr = sprColorAddr;
 
-    if ((screenY < 240) && (screenX <= 256) && (screenX > 0)) // draw pixel using screenX, screenY, and palette (calculated from above conditional)
+    if (actions & DOTaction::drawPixel)     // draw pixel using screenX, screenY, and palette (calculated from above conditional)
     {
-        uint8_t paletteData = (mem->ppuRead(0x3F00 + colorAddr)) & 0x3F;
+        uint8_t paletteData = paletteColor[colorAddr];
         if (registers[1] & PPUMASKmask::grayscale)
             paletteData &= 0x30;
-        ((RGB*)screenBuffer)[(screenY * 256) + screenX - 1] = paletteRGB[paletteData];
+        screenIndices[(screenY * 256) + screenX - 1] = paletteData;
     }
 
     // -------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
     // other PPU clock cycle functions here
     // -------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-    if ((screenY <= 239) || (screenY == 261))   // for visible scanlines
+    if (registers[1] & (PPUMASKmask::showBackground | PPUMASKmask::showSprites))
     {
-        if (registers[1] & (PPUMASKmask::showBackground | PPUMASKmask::showSprites))
-        {
-            if ((((screenX >= 1) && (screenX <= 256)) || ((screenX >= 321) && (screenX <= 336))) && ((screenX & 0x07) == 0x07))   // && !(screenX & 0x07))   // update VRAM address
-            {
-                if (screenX != 255)     // increment v horizontally (256)
-                {
-                    if ((vramAddrCurr & VRAMmask::coarseX) == 31)
-                    {
-                        vramAddrCurr &= ~(VRAMmask::coarseX);
-                        vramAddrCurr ^= VRAMmask::nametableID0;
-                    }
-                    else
-                        vramAddrCurr++;
-                }
-                else                    // increment v vertically
-                {
-                    vramAddrCurr = (vramAddrCurr + 0x1000) & 0x7FFF;
-                    if (!(vramAddrCurr & VRAMmask::fineY))
-                    {
-                        uint8_t coarseY = (vramAddrCurr & VRAMmask::coarseY) >> 5;
-                        if (coarseY == 29)
-                        {
-                            vramAddrCurr &= ~(VRAMmask::coarseY);
-                            vramAddrCurr ^= VRAMmask::nametableID1;
-                        }
-                        else if (coarseY == 31)
-                        {
-                            vramAddrCurr &= ~(VRAMmask::coarseY);
-                        }
-                        else
-                            vramAddrCurr += 0x0020; // increment coarseY
-                    }       
-                }
-            }
-            else if (screenX == 257)
-                vramAddrCurr = (vramAddrCurr & ~(VRAMmask::coarseX | VRAMmask::nametableID0)) | (vramAddrTemp & (VRAMmask::coarseX | VRAMmask::nametableID0));
-            else if ((screenY == 261) && (screenX >= 280) && (screenX <= 304))
-                vramAddrCurr = (vramAddrCurr & ~(VRAMmask::coarseY | VRAMmask::nametableID1 | VRAMmask::fineY)) | (vramAddrTemp & (VRAMmask::coarseY | VRAMmask::nametableID1 | VRAMmask::fineY));
-        }
-
-        if ((screenX >= 257) && (screenX <= 320))   // OAMADDR is set to 0 during each of ticks 257-320 (the sprite tile loading interval) of the pre-render and visible scanlines
-            registers[3] = 0x00;
-
+        if (actions & DOTaction::scrollHorizontal)      // update VRAM address
+            incrementHorizontal();
+        else if (actions & DOTaction::scrollVertical)
+            incrementVertical();
+        else if (actions & DOTaction::copyHorizontal)
+            vramAddrCurr = (vramAddrCurr & ~(VRAMmask::coarseX | VRAMmask::nametableID0)) | (vramAddrTemp & (VRAMmask::coarseX | VRAMmask::nametableID0));
+        else if (actions & DOTaction::copyVertical)
+            vramAddrCurr = (vramAddrCurr & ~(VRAMmask::coarseY | VRAMmask::nametableID1 | VRAMmask::fineY)) | (vramAddrTemp & (VRAMmask::coarseY | VRAMmask::nametableID1 | VRAMmask::fineY));
     }
-    NMI = false;
-    if ((screenY == 241) && (screenX == 1))
+    if (actions & DOTaction::resetOAMaddr)  // OAMADDR is set to 0 during each of ticks 257-320 (the sprite tile loading interval) of the pre-render and visible scanlines
+        registers[3] = 0x00;
+    if (actions & DOTaction::setVblank)
     {
         registers[2] |= PPUSTATUSmask::vblankFlag;
         if(registers[0] & PPUCTRLmask::vblankInterval)
-            NMI = true;
+            scheduler->raise(NES::nmi);
     }
 
     // -------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -706,11 +1017,10 @@ void ricoh2C02::PPU::tick()
         if (screenY > 261)
             screenY = 0;
     }
-    frameDone = false;
     if ((screenY == 239) && (screenX == 256))
     {
         oddFrame = !oddFrame;
-        frameDone = true;
+        scheduler->raise(NES::frameEnd);
     }
     else if ((screenY == 0) && (screenX == 0) && oddFrame && (registers[1] & (PPUMASKmask::showBackground | PPUMASKmask::showSprites))) // odd frame skip
     {
@@ -720,17 +1030,302 @@ void ricoh2C02::PPU::tick()
         PPUCTRLpost30000++;
 }
 
-bool ricoh2C02::PPU::frameComplete()
+// dots 1-256 of a visible scanline in one call, with the same results as ticking them one by one
+// (only called by catchUp(), so no CPU register access or mapper change can fall in the middle of it; see there)
+// the fetches, the sprite line buffer, the priority mux (muxLine(), vectorised where the CPU allows) and the palette lookup are done in separate passes,
+// which keeps each loop free of the per-dot range checks
+template<class Bus>
+void ricoh2C02::PPU<Bus>::renderScanline()
 {
-    return frameDone;
+    const bool bgEnabled = registers[1] & PPUMASKmask::showBackground;
+    const bool sprEnabled = registers[1] & PPUMASKmask::showSprites;
+    const bool renderBackgroundAndSprites = bgEnabled && sprEnabled;
+    const uint16_t bgPatternTable = (registers[0] & PPUCTRLmask::backgroundPatternTable)? 0x1000 : 0x0000;
+    const uint16_t sprite0HitStart = (registers[1] & (PPUMASKmask::showLeftmostBackground | PPUMASKmask::showLeftmostSprite))? 1 : 9;
+    uint8_t bgColorAddr[256], sprZero[256], colorAddr[256];     // one entry per dot, dot 1 first
+
+    // background, a tile at a time: dot 1 reloads the shifters, then each run of 8 dots (2-9, 10-17, ... 242-249) takes its pixels from one
+    // shifter load and does the fetches falling on its dots after them (they only reach the shifters on the reload ending the run)
+    // dots 250-256 are a shorter run left for tick() to reload on dot 257
+    backgroundPixels(bgColorAddr, 1, bgEnabled);
+    if ((screenY == 0) && oddFrame)
+        bgNextTileID = mem->ppuRead(0x2000 | (vramAddrCurr & 0x0FFF));
+    bgPalette1Latch = (bgNextTileAttr & 0x02)? true : false;
+    bgPalette0Latch = (bgNextTileAttr & 0x01)? true : false;
+    bgPatternShifter |= bgNextPattern;
+    for (uint16_t x = 2; x <= 250; x += 8)
+    {
+        backgroundPixels(bgColorAddr + x - 1, (x != 250)? 8 : 7, bgEnabled);
+        // dot x: attribute byte
+        bgNextTileAttr = mem->ppuRead(0x23C0 | (vramAddrCurr & VRAMmask::nametableID)
+                                             | (((vramAddrCurr & VRAMmask::coarseY) >> 4) & 0x0038)
+                                             | ((vramAddrCurr & VRAMmask::coarseX) >> 2));
+        if (vramAddrCurr & VRAMmask::coarseY & 0x0040)
+            bgNextTileAttr >>= 4;
+        if (vramAddrCurr & VRAMmask::coarseX & 0x0002)
+            bgNextTileAttr >>= 2;
+        // dot x + 2: both pattern planes at once (no bank switch can happen before dot x + 4)
+        bgNextPattern = mem->ppuTile(bgPatternTable + (bgNextTileID << 4) + ((vramAddrCurr & VRAMmask::fineY) >> 12))[0];
+        // dot x + 5: v increment (vertical on dot 255)
+        if (bgEnabled || sprEnabled)
+        {
+            if (x != 250)
+                incrementHorizontal();
+            else
+                incrementVertical();
+        }
+        // dot x + 6: nametable byte
+        bgNextTileID = mem->ppuRead(0x2000 | (vramAddrCurr & 0x0FFF));
+        // dot x + 7: reload
+        if (x != 250)
+        {
+            bgPalette1Latch = (bgNextTileAttr & 0x02)? true : false;
+            bgPalette0Latch = (bgNextTileAttr & 0x01)? true : false;
+            bgPatternShifter |= bgNextPattern;
+        }
+    }
+
+    uint8_t *line = screenIndices + (screenY * 256);
+    if (!bgEnabled && !sprEnabled)      // rendering off: backdrop colour all along
+    {
+        sprDot = 0;
+        sprite0HitDot = 0;
+        memset(line, (registers[1] & PPUMASKmask::grayscale)? (paletteColor[0] & 0x30) : paletteColor[0], 256);
+    }
+    else
+    {
+        // sprite line buffer
+        static const uint8_t noSprites[256] = {0};
+        sprDot = 0;
+        if (sprEnabled)
+        {
+            rasterizeSprites();
+            sprDot = 256;
+        }
+        memset(sprZero, 0x00, 256);
+        if (renderSprite0 && renderBackgroundAndSprites)
+            memcpy(sprZero + sprite0HitStart - 1, sprLineZero + sprite0HitStart - 1, 255 - (sprite0HitStart - 1));
+
+        // priority mux
+        sprite0HitDot = (sprEnabled)? muxLine(bgColorAddr, sprLineColor, sprLineBehind, sprZero, colorAddr)
+                                    : muxLine(bgColorAddr, noSprites, noSprites, noSprites, colorAddr);
+        if (sprite0HitDot)
+            registers[2] |= PPUSTATUSmask::sprite0HitFlag;
+
+        // palette lookup
+        for (uint16_t i = 0; i < 256; i++)
+        {
+            uint8_t paletteData = paletteColor[colorAddr[i]];
+            if (registers[1] & PPUMASKmask::grayscale)
+                paletteData &= 0x30;
+            line[i] = paletteData;
+        }
+    }
+
+    // secondary OAM for the next scanline (dots 1 and 65)
+    memset(OAMsecondary, 0xFF, 8 * 4 * sizeof(uint8_t));
+    nxtSprToRender = 0;
+    nxtRenderSprite0 = false;
+    evaluateSprites();
+
+    PPUCTRLpost30000 = ((PPUCTRLpost30000 + 256) < 30000)? (PPUCTRLpost30000 + 256) : 30000;
 }
 
-uint8_t* const ricoh2C02::PPU::getScreen()
+template<class Bus>
+void ricoh2C02::PPU<Bus>::catchUp()
 {
+    uint64_t now = scheduler->now;
+    if (nextDotTime > now)
+        return;
+    // visible scanlines are rendered in one go at dot 1 (nothing can alter PPU state before the CPU catches it up)
+    // if dots 1-256 are not all owed yet the scanline is rendered ahead, and only redone dot by dot if the CPU alters PPU state before dot 257
+    // mappers watching A12 need the pattern fetches in step with the CPU, so they always get single dots
+    const bool scanlines = !(mem->mapperWatchesA12());
+    while (nextDotTime <= now)
+    {
+        if (renderedAhead)      // its pixels are drawn; only its status flags are left to show on their dots
+        {
+            if (screenX == 65)
+                registers[2] |= (aheadStatus & PPUSTATUSmask::spriteOverflowFlag);
+            if (screenX == sprite0HitDot)
+                registers[2] |= (aheadStatus & PPUSTATUSmask::sprite0HitFlag);
+            screenX++;
+            if (screenX == 257)
+                renderedAhead = false;
+            nextDotTime += dotStep[dotInCycle];
+            dotInCycle = (dotInCycle == 2)? 0 : (dotInCycle + 1);
+            continue;
+        }
+        if ((screenY >= 240) && (screenY <= 260) && ((screenY != 241) || (screenX != 1)) && vblankIdle())
+        {
+            skipVblank(now);
+            continue;
+        }
+        if (scanlines && (screenX == 1) && (screenY <= 239))
+        {
+            if ((nextDotTime + (6 * 85)) <= now)
+            {
+                uint64_t dot255Time = nextDotTime + (6 * 84) + dotStep[dotInCycle] + dotStep[(dotInCycle == 2)? 0 : (dotInCycle + 1)];
+                renderScanline();
+                screenX = 257;
+                if (screenY == 239)     // frame end is raised by dot 255 (see tick())
+                {
+                    scheduler->now = dot255Time;
+                    oddFrame = !oddFrame;
+                    scheduler->raise(NES::frameEnd);
+                }
+                nextDotTime += (6 * 85) + dotStep[dotInCycle];  // 256 dots
+                dotInCycle = (dotInCycle == 2)? 0 : (dotInCycle + 1);
+                continue;
+            }
+            else if (screenY != 239)    // (the last scanline is left to tick() so the frame ends with the same pixels drawn)
+            {
+                lineStart = {bgPalette1shifter, bgPalette0shifter, bgPatternShifter, bgPalette1Latch, bgPalette0Latch,
+                             bgNextTileID, bgNextTileAttr, bgNextPattern, vramAddrCurr, {}, nxtSprToRender, nxtRenderSprite0,
+                             registers[2], PPUCTRLpost30000};
+                memcpy(lineStart.OAMsecondary, OAMsecondary, 8 * 4);
+                renderScanline();
+                aheadStatus = registers[2];
+                registers[2] = lineStart.status;
+                renderedAhead = true;
+                continue;
+            }
+        }
+        scheduler->now = nextDotTime;   // so anything raised during the dot is stamped with its own time
+        tick();
+        nextDotTime += dotStep[dotInCycle];
+        dotInCycle = (dotInCycle == 2)? 0 : (dotInCycle + 1);
+    }
+    scheduler->now = now;
+    scheduleSync();
+}
+
+// the shifters left from the last scanline stay put through vblank, so the only thing a dot there can still do is a sprite 0 hit
+// (sprite 0 at the front of the shifters over an opaque background pixel; see tick())
+template<class Bus>
+bool ricoh2C02::PPU<Bus>::vblankIdle()
+{
+    const uint8_t renderBoth = PPUMASKmask::showBackground | PPUMASKmask::showSprites;
+    return !(((registers[1] & renderBoth) == renderBoth) && !(registers[2] & PPUSTATUSmask::sprite0HitFlag)
+             && renderSprite0 && sprToRender && !(sprPosX[0]) && (sprPatternShifter[0] >> 14)
+             && ((bgPatternShifter >> (30 - (fineX << 1))) & 0x03));
+}
+
+template<class Bus>
+void ricoh2C02::PPU<Bus>::skipVblank(uint64_t now)
+{
+    uint32_t pos = (screenY * 341) + screenX;
+    uint32_t limit = ((pos <= (241 * 341))? ((241 * 341) + 1) : (261 * 341)) - pos;
+    uint32_t dots = (uint32_t)(std::min<uint64_t>((now - nextDotTime) / 6, limit / 3)) * 3;
+    nextDotTime += 2 * dots;    // (3 dots to every 6 phases)
+    while ((dots < limit) && (nextDotTime <= now))
+    {
+        nextDotTime += dotStep[dotInCycle];
+        dotInCycle = (dotInCycle == 2)? 0 : (dotInCycle + 1);
+        dots++;
+    }
+    pos += dots;
+    screenY = pos / 341;
+    screenX = pos % 341;
+    PPUCTRLpost30000 = (uint16_t)(std::min<uint32_t>(PPUCTRLpost30000 + dots, 30000));
+}
+
+template<class Bus>
+void ricoh2C02::PPU<Bus>::catchUpForWrite()
+{
+    catchUp();
+    if (renderedAhead)
+        redoScanline();
+}
+
+template<class Bus>
+void ricoh2C02::PPU<Bus>::redoScanline()
+{
+    uint16_t owedX = screenX;
+    bgPalette1shifter = lineStart.bgPalette1shifter;
+    bgPalette0shifter = lineStart.bgPalette0shifter;
+    bgPatternShifter = lineStart.bgPatternShifter;
+    bgPalette1Latch = lineStart.bgPalette1Latch;
+    bgPalette0Latch = lineStart.bgPalette0Latch;
+    bgNextTileID = lineStart.bgNextTileID;
+    bgNextTileAttr = lineStart.bgNextTileAttr;
+    bgNextPattern = lineStart.bgNextPattern;
+    vramAddrCurr = lineStart.vramAddrCurr;
+    memcpy(OAMsecondary, lineStart.OAMsecondary, 8 * 4);
+    nxtSprToRender = lineStart.nxtSprToRender;
+    nxtRenderSprite0 = lineStart.nxtRenderSprite0;
+    registers[2] = (registers[2] & PPUSTATUSmask::vblankFlag) | (lineStart.status & ~(PPUSTATUSmask::vblankFlag));
+    PPUCTRLpost30000 = lineStart.PPUCTRLpost30000;
+    renderedAhead = false;
+    screenX = 1;
+    while (screenX < owedX)     // no events are raised on these dots, so the scheduler's time can stay as is
+        tick();
+}
+
+template<class Bus>
+void ricoh2C02::PPU<Bus>::scheduleSync()
+{
+    // dots after the next one until the dot at (241, 1) raising NMI and the one at (239, 255) raising frame end
+    // (wrapping past the pre-render scanline counts one dot less as the odd frame skip might happen; syncing early is harmless)
+    const uint32_t frameDots = 341 * 262;
+    const uint32_t targets[2] = {(241 * 341) + 1, (239 * 341) + 255};
+    uint32_t pos = (screenY * 341) + screenX;
+    uint32_t dots = frameDots;
+    for (uint32_t target : targets)
+    {
+        uint32_t d = (target >= pos)? (target - pos) : (target + frameDots - pos - 1);
+        if (d < dots)
+            dots = d;
+    }
+    if (mem->mapperWatchesA12())    // pattern fetches on visible and pre-render scanlines move A12, so stay in step with the CPU there
+    {
+        if ((screenY <= 239) || (screenY == 261))
+            dots = 0;
+        else if (((261 * 341) - pos) < dots)
+            dots = (261 * 341) - pos;
+    }
+
+    uint64_t at = nextDotTime + (6 * (dots / 3));
+    uint8_t dot = dotInCycle;
+    for (uint32_t i = 0; i < (dots % 3); i++)
+    {
+        at += dotStep[dot];
+        dot = (dot == 2)? 0 : (dot + 1);
+    }
+    scheduler->schedule(NES::ppuSync, at);
+}
+
+template<class Bus>
+void ricoh2C02::PPU<Bus>::paletteWrite(uint16_t addr, uint8_t data)
+{
+    addr &= 0x001F;
+    palette[addr] = data;
+    paletteColor[addr] = data & 0x3F;
+    if (!(addr & 0x0003))   // "addresses $3F10/$3F14/$3F18/$3F1C are mirrors of $3F00/$3F04/$3F08/$3F0C"
+    {
+        palette[addr ^ 0x0010] = data;
+        paletteColor[addr ^ 0x0010] = data & 0x3F;
+    }
+}
+
+template<class Bus>
+uint8_t* const ricoh2C02::PPU<Bus>::getScreen()
+{
+    indicesToRGB(screenIndices, screenBuffer, paletteRGBX, 256 * 240);
     return screenBuffer;
 }
 
-bool ricoh2C02::PPU::triggerNMI()
+template<class Bus>
+uint8_t* const ricoh2C02::PPU<Bus>::getScreenIndices()
 {
-    return NMI;
-}
\ No newline at end of file
+    return screenIndices;
+}
+
+
+
+// one PPU per bus it can be wired to (see NES::Console::initCartridge())
+template class ricoh2C02::PPU<NES::Bus<NES::Mapper0>>;
+template class ricoh2C02::PPU<NES::Bus<NES::Mapper1>>;
+template class ricoh2C02::PPU<NES::Bus<NES::Mapper2>>;
+template class ricoh2C02::PPU<NES::Bus<NES::Mapper3>>;
+template class ricoh2C02::PPU<NES::Bus<NES::Mapper4>>;
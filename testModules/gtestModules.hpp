@@ -24,8 +24,6 @@ namespace NES
             delete[] cpuMemory;
         }
 
-        void initCartridge(std::string filename) {}
-
         uint8_t cpuRead(uint16_t addr)
         {
             if (addr <= 0x1FFF)
@@ -58,12 +56,10 @@ namespace NES
         // filler functions as no PPU tests
         uint8_t ppuRead(uint16_t addr) {return 0x00;}
         bool ppuWrite(uint16_t addr, uint8_t data) {return false;}
-        void connect(ricoh2A03::CPU *c, ricoh2C02::PPU *p, ricoh2A03::APU *a) {}
         uint8_t controllerRead(uint8_t player) {return 0x00;}
-        bool mapperIrqReq() {return false;}
         void mapperIrqReset() {}
+        bool mapperWatchesA12() {return false;}
         void controllerWrite(uint8_t player, uint8_t data) {}
-        void toggleCpuCycle() {}
         void ppuRequestDMA() {}
         void finalizeDMAreq() {}
         bool DMAactive() {return false;}
@@ -86,7 +82,7 @@ namespace NES
         cpuTest()
         {
             mem = new GTESTmemory();
-            cpu = new ricoh2A03::CPU(mem);
+            cpu = new ricoh2A03::CPU<Memory>(mem);
             cpu->rst();
         }
 
@@ -110,7 +106,7 @@ namespace NES
         };
 
         Memory *mem = nullptr;
-        ricoh2A03::CPU *cpu = nullptr;
+        ricoh2A03::CPU<Memory> *cpu = nullptr;
 
         void test(uint8_t ticks, cpuState initState, std::map<uint16_t, uint8_t> &initMem, cpuState finalState, std::map<uint16_t, uint8_t> &finalMem)
         {
@@ -144,7 +140,7 @@ namespace NES
 
 
 
-    // NOTE: tests only include offical opcodes
+    // NOTE: tests only include offical opcodes (plus the stable unofficial ones after testRTI)
 
     TEST_F(cpuTest, testLDA)    // 0xA1 0xA5 0xA9 0xAD 0xB1 0xB5 0xB9 0xBD
     {
@@ -3202,6 +3198,153 @@ namespace NES
         std::map<uint16_t, uint8_t> finalMemIMP2 {};
         test(6, initStateIMP2, initMemIMP2, finalStateIMP2, finalMemIMP2);
     }
+
+    TEST_F(cpuTest, testLAX)    // 0xA3 0xA7 0xAF 0xB3 0xB7 0xBF (unofficial)
+    {
+        // ZP
+        cpuState initStateZP {0x0000, 0xFF, 0x00, 0x00, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> initMemZP {
+            {0x0000, 0xA7}, {0x0001, 0xAA},
+            {0x00AA, 0x80}
+        };
+        cpuState finalStateZP {0x0002, 0xFF, 0x80, 0x80, 0x00, ricoh2A03::negativeFlag};
+        std::map<uint16_t, uint8_t> finalMemZP {};
+        test(3, initStateZP, initMemZP, finalStateZP, finalMemZP);
+
+        // ABSY (page crossed)
+        cpuState initStateABSY {0x0000, 0xFF, 0x11, 0x22, 0x01, 0x00};
+        std::map<uint16_t, uint8_t> initMemABSY {
+            {0x0000, 0xBF}, {0x0001, 0xFF}, {0x0002, 0x01},
+            {0x0200, 0x00}
+        };
+        cpuState finalStateABSY {0x0003, 0xFF, 0x00, 0x00, 0x01, ricoh2A03::zeroFlag};
+        std::map<uint16_t, uint8_t> finalMemABSY {};
+        test(5, initStateABSY, initMemABSY, finalStateABSY, finalMemABSY);
+    }
+
+    TEST_F(cpuTest, testSAX)    // 0x83 0x87 0x8F 0x97 (unofficial)
+    {
+        // ZP
+        cpuState initStateZP {0x0000, 0xFF, 0xF0, 0x3C, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> initMemZP {
+            {0x0000, 0x87}, {0x0001, 0xAA}
+        };
+        cpuState finalStateZP {0x0002, 0xFF, 0xF0, 0x3C, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> finalMemZP {
+            {0x00AA, 0x30}
+        };
+        test(3, initStateZP, initMemZP, finalStateZP, finalMemZP);
+
+        // ZPY (wraps within the zero page)
+        cpuState initStateZPY {0x0000, 0xFF, 0xF0, 0x3C, 0x60, 0x00};
+        std::map<uint16_t, uint8_t> initMemZPY {
+            {0x0000, 0x97}, {0x0001, 0xAA}
+        };
+        cpuState finalStateZPY {0x0002, 0xFF, 0xF0, 0x3C, 0x60, 0x00};
+        std::map<uint16_t, uint8_t> finalMemZPY {
+            {0x000A, 0x30}
+        };
+        test(4, initStateZPY, initMemZPY, finalStateZPY, finalMemZPY);
+    }
+
+    TEST_F(cpuTest, testSLO)    // 0x03 0x07 0x0F 0x13 0x17 0x1B 0x1F (unofficial)
+    {
+        // ZP
+        cpuState initStateZP {0x0000, 0xFF, 0x02, 0x00, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> initMemZP {
+            {0x0000, 0x07}, {0x0001, 0xAA},
+            {0x00AA, 0x81}
+        };
+        cpuState finalStateZP {0x0002, 0xFF, 0x02, 0x00, 0x00, ricoh2A03::carryFlag};
+        std::map<uint16_t, uint8_t> finalMemZP {
+            {0x00AA, 0x02}
+        };
+        test(5, initStateZP, initMemZP, finalStateZP, finalMemZP);
+
+        // ABSX (no page crossing penalty)
+        cpuState initStateABSX {0x0000, 0xFF, 0x01, 0xFF, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> initMemABSX {
+            {0x0000, 0x1F}, {0x0001, 0x00}, {0x0002, 0x02},
+            {0x02FF, 0x40}
+        };
+        cpuState finalStateABSX {0x0003, 0xFF, 0x81, 0xFF, 0x00, ricoh2A03::negativeFlag};
+        std::map<uint16_t, uint8_t> finalMemABSX {
+            {0x02FF, 0x80}
+        };
+        test(7, initStateABSX, initMemABSX, finalStateABSX, finalMemABSX);
+    }
+
+    TEST_F(cpuTest, testDCP)    // 0xC3 0xC7 0xCF 0xD3 0xD7 0xDB 0xDF (unofficial)
+    {
+        // ZP
+        cpuState initStateZP {0x0000, 0xFF, 0x10, 0x00, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> initMemZP {
+            {0x0000, 0xC7}, {0x0001, 0xAA},
+            {0x00AA, 0x11}
+        };
+        cpuState finalStateZP {0x0002, 0xFF, 0x10, 0x00, 0x00, (ricoh2A03::carryFlag | ricoh2A03::zeroFlag)};
+        std::map<uint16_t, uint8_t> finalMemZP {
+            {0x00AA, 0x10}
+        };
+        test(5, initStateZP, initMemZP, finalStateZP, finalMemZP);
+    }
+
+    TEST_F(cpuTest, testISC)    // 0xE3 0xE7 0xEF 0xF3 0xF7 0xFB 0xFF (unofficial)
+    {
+        // ZP
+        cpuState initStateZP {0x0000, 0xFF, 0x20, 0x00, 0x00, ricoh2A03::carryFlag};
+        std::map<uint16_t, uint8_t> initMemZP {
+            {0x0000, 0xE7}, {0x0001, 0xAA},
+            {0x00AA, 0x0F}
+        };
+        cpuState finalStateZP {0x0002, 0xFF, 0x10, 0x00, 0x00, ricoh2A03::carryFlag};
+        std::map<uint16_t, uint8_t> finalMemZP {
+            {0x00AA, 0x10}
+        };
+        test(5, initStateZP, initMemZP, finalStateZP, finalMemZP);
+    }
+
+    TEST_F(cpuTest, testAXS)    // 0xCB (unofficial)
+    {
+        // IMM
+        cpuState initStateIMM {0x0000, 0xFF, 0xF0, 0x3C, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> initMemIMM {
+            {0x0000, 0xCB}, {0x0001, 0x10}
+        };
+        cpuState finalStateIMM {0x0002, 0xFF, 0xF0, 0x20, 0x00, ricoh2A03::carryFlag};
+        std::map<uint16_t, uint8_t> finalMemIMM {};
+        test(2, initStateIMM, initMemIMM, finalStateIMM, finalMemIMM);
+    }
+
+    TEST_F(cpuTest, testXNOP)   // 0x1A 0x80 0x1C ... (unofficial)
+    {
+        // IMP
+        cpuState initStateIMP {0x0000, 0xFF, 0x00, 0x00, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> initMemIMP {
+            {0x0000, 0x1A}
+        };
+        cpuState finalStateIMP {0x0001, 0xFF, 0x00, 0x00, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> finalMemIMP {};
+        test(2, initStateIMP, initMemIMP, finalStateIMP, finalMemIMP);
+
+        // IMM
+        cpuState initStateIMM {0x0000, 0xFF, 0x00, 0x00, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> initMemIMM {
+            {0x0000, 0x80}, {0x0001, 0xAA}
+        };
+        cpuState finalStateIMM {0x0002, 0xFF, 0x00, 0x00, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> finalMemIMM {};
+        test(2, initStateIMM, initMemIMM, finalStateIMM, finalMemIMM);
+
+        // ABSX (page crossed)
+        cpuState initStateABSX {0x0000, 0xFF, 0x00, 0x01, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> initMemABSX {
+            {0x0000, 0x1C}, {0x0001, 0xFF}, {0x0002, 0x01}
+        };
+        cpuState finalStateABSX {0x0003, 0xFF, 0x00, 0x01, 0x00, 0x00};
+        std::map<uint16_t, uint8_t> finalMemABSX {};
+        test(5, initStateABSX, initMemABSX, finalStateABSX, finalMemABSX);
+    }
 }
 
 